@@ -177,6 +177,16 @@ struct ConfigFileSetting config_file_settings[] =
 		{},
 		{}
 	},
+	/* log_async */
+	{
+		"log_async",
+		CONFIG_BOOL,
+		{ .boolptr = &config_file_options.log_async },
+		{ .booldefault = false },
+		{},
+		{},
+		{}
+	},
 	/* ======================
 	 * standby clone settings
 	 * ======================
@@ -400,6 +410,16 @@ struct ConfigFileSetting config_file_settings[] =
 		{},
 		{}
 	},
+	/* archive_ready_cache_ttl */
+	{
+		"archive_ready_cache_ttl",
+		CONFIG_INT,
+		{ .intptr = &config_file_options.archive_ready_cache_ttl },
+		{ .intdefault = DEFAULT_ARCHIVE_READY_CACHE_TTL },
+		{ .intminval = 0 },
+		{},
+		{}
+	},
 	/* replication_lag_warning */
 	{
 		"replication_lag_warning",
@@ -581,6 +601,16 @@ struct ConfigFileSetting config_file_settings[] =
 		{ .strmaxlen = sizeof(config_file_options.repmgrd_pid_file) },
 		{ .postprocess_func = &repmgr_canonicalize_path }
 	},
+	/* repmgrd_metrics_file */
+	{
+		"repmgrd_metrics_file",
+		CONFIG_STRING,
+		{ .strptr = config_file_options.repmgrd_metrics_file },
+		{ .strdefault = "" },
+		{},
+		{ .strmaxlen = sizeof(config_file_options.repmgrd_metrics_file) },
+		{ .postprocess_func = &repmgr_canonicalize_path }
+	},
 	/* standby_disconnect_on_failover */
 	{
 		"standby_disconnect_on_failover",
@@ -711,6 +741,16 @@ struct ConfigFileSetting config_file_settings[] =
 		{ .strmaxlen = sizeof(config_file_options.child_nodes_disconnect_command) },
 		{}
 	},
+	/* child_nodes_disconnect_command_timeout */
+	{
+		"child_nodes_disconnect_command_timeout",
+		CONFIG_INT,
+		{ .intptr = &config_file_options.child_nodes_disconnect_command_timeout },
+		{ .intdefault = DEFAULT_CHILD_NODES_DISCONNECT_COMMAND_TIMEOUT },
+		{ .intminval = 1 },
+		{},
+		{}
+	},
 	/* ================
 	 * service settings
 	 * ================
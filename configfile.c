@@ -18,6 +18,7 @@
  */
 
 #include <sys/stat.h>			/* for stat() */
+#include <fcntl.h>
 
 #include "repmgr.h"
 #include "configfile.h"
@@ -50,6 +51,43 @@ static void tablespace_list_free(t_configuration_options *options);
 
 static void exit_with_config_file_errors(ItemList *config_errors, ItemList *config_warnings, bool terse);
 
+static bool read_config_file_cache(void);
+static void write_config_file_cache(void);
+
+/*
+ * Binary cache of a successfully parsed configuration file, stored
+ * alongside the configuration file itself. The cache is keyed on the
+ * configuration file's device/inode/size/mtime, so any change to the file
+ * invalidates it; REPMGR_VERSION_NUM and the size of
+ * t_configuration_options guard against reading a cache written by a
+ * different repmgr version or build. Configurations which pull in
+ * further files via include directives are never cached, as changes to
+ * those files would go unnoticed.
+ *
+ * This enables frequently executed commands (e.g. "repmgr node check"
+ * driven by a monitoring system) to skip the scanning and validation of
+ * the configuration file entirely. Set the environment variable
+ * "REPMGR_NO_CONFIG_CACHE" to disable the cache.
+ */
+
+#define CONFIG_CACHE_SUFFIX ".cache"
+#define CONFIG_CACHE_MAGIC 0x524D4743	/* "RMGC" */
+
+typedef struct
+{
+	uint32		magic;
+	int			version_num;	/* REPMGR_VERSION_NUM of the writing binary */
+	uint32		options_size;	/* sizeof(t_configuration_options) */
+	dev_t		config_dev;
+	ino_t		config_ino;
+	off_t		config_size;
+	time_t		config_mtime;
+	uint32		tablespace_count;
+	uint32		event_notification_count;
+} t_config_cache_header;
+
+static bool config_file_parsed_from_cache = false;
+
 
 void
 set_progname(const char *argv0)
@@ -266,6 +304,24 @@ parse_config(bool terse)
 		print_item_list(&config_warnings);
 	}
 
+	/*
+	 * Cache the result of a clean parse (no errors or warnings) so
+	 * subsequent invocations can skip it; if the file produced warnings,
+	 * don't cache, so they're re-emitted each time.
+	 *
+	 * Configurations assembled via "include", "include_if_exists" or
+	 * "include_dir" are never cached, as the cache is keyed on the
+	 * top-level file only and would not notice changes to (or addition
+	 * of) included files.
+	 */
+	if (config_file_found == true &&
+		config_file_parsed_from_cache == false &&
+		config_file_include_processed == false &&
+		config_warnings.head == NULL)
+	{
+		write_config_file_cache();
+	}
+
 	return;
 }
 
@@ -279,6 +335,8 @@ _parse_config(ItemList *error_list, ItemList *warning_list)
 	ConfigFileSetting *setting;
 	int i = 0;
 
+	config_file_parsed_from_cache = false;
+
 	/*
 	 * Clear lists pointing to allocated memory
 	 */
@@ -366,10 +424,19 @@ _parse_config(ItemList *error_list, ItemList *warning_list)
 
 	fclose(fp);
 
+	/*
+	 * If a cache of a previous successful parse of this exact file state
+	 * exists, use it and skip the scanning and validation below entirely.
+	 */
+	if (read_config_file_cache() == true)
+		return;
+
 	strncpy(base_directory, config_file_path, MAXPGPATH);
 	canonicalize_path(base_directory);
 	get_parent_directory(base_directory);
 
+	config_file_include_processed = false;
+
 	config_ok = ProcessRepmgrConfigFile(config_file_path, base_directory, error_list, warning_list);
 
 	/*
@@ -466,6 +533,277 @@ _parse_config(ItemList *error_list, ItemList *warning_list)
 }
 
 
+/*
+ * Attempt to load the configuration from the binary cache file written by
+ * a previous successful parse of the current configuration file.
+ *
+ * Returns true if "config_file_options" was populated from the cache;
+ * any validation failure simply means the file will be parsed as usual.
+ */
+static bool
+read_config_file_cache(void)
+{
+	char		cache_file_path[MAXPGPATH + sizeof(CONFIG_CACHE_SUFFIX)] = "";
+	struct stat statbuf;
+	struct stat cache_statbuf;
+	FILE	   *fp;
+	t_config_cache_header header;
+	t_configuration_options cached_options;
+	TablespaceListCell *tablespace_cells = NULL;
+	EventNotificationListCell *event_cells = NULL;
+	uint32		i;
+
+	if (getenv("REPMGR_NO_CONFIG_CACHE") != NULL)
+		return false;
+
+	if (stat(config_file_path, &statbuf) != 0)
+		return false;
+
+	snprintf(cache_file_path, sizeof(cache_file_path),
+			 "%s%s",
+			 config_file_path,
+			 CONFIG_CACHE_SUFFIX);
+
+	fp = fopen(cache_file_path, "r");
+
+	if (fp == NULL)
+		return false;
+
+	/*
+	 * As the cache bypasses configuration file validation, don't trust it
+	 * unless it is owned by the current user and writable only by them.
+	 */
+	if (fstat(fileno(fp), &cache_statbuf) != 0 ||
+		cache_statbuf.st_uid != geteuid() ||
+		(cache_statbuf.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+	{
+		log_debug("ignoring configuration cache file \"%s\" with unexpected ownership or permissions",
+				  cache_file_path);
+		fclose(fp);
+		return false;
+	}
+
+	if (fread(&header, sizeof(t_config_cache_header), 1, fp) != 1 ||
+		header.magic != CONFIG_CACHE_MAGIC ||
+		header.version_num != REPMGR_VERSION_NUM ||
+		header.options_size != sizeof(t_configuration_options) ||
+		header.config_dev != statbuf.st_dev ||
+		header.config_ino != statbuf.st_ino ||
+		header.config_size != statbuf.st_size ||
+		header.config_mtime != statbuf.st_mtime)
+	{
+		fclose(fp);
+		return false;
+	}
+
+	/*
+	 * Read everything into local storage before touching
+	 * "config_file_options", so a truncated cache file can't leave a
+	 * half-initialised configuration behind.
+	 */
+	if (fread(&cached_options, sizeof(t_configuration_options), 1, fp) != 1)
+	{
+		fclose(fp);
+		return false;
+	}
+
+	if (header.tablespace_count > 0)
+	{
+		tablespace_cells = pg_malloc0(sizeof(TablespaceListCell) * header.tablespace_count);
+
+		if (fread(tablespace_cells, sizeof(TablespaceListCell), header.tablespace_count, fp) != header.tablespace_count)
+		{
+			pg_free(tablespace_cells);
+			fclose(fp);
+			return false;
+		}
+	}
+
+	if (header.event_notification_count > 0)
+	{
+		event_cells = pg_malloc0(sizeof(EventNotificationListCell) * header.event_notification_count);
+
+		if (fread(event_cells, sizeof(EventNotificationListCell), header.event_notification_count, fp) != header.event_notification_count)
+		{
+			pg_free(tablespace_cells);
+			pg_free(event_cells);
+			fclose(fp);
+			return false;
+		}
+	}
+
+	fclose(fp);
+
+	/* the embedded list pointers belong to the writing process */
+	memset(&cached_options.tablespace_mapping, 0, sizeof(TablespaceList));
+	memset(&cached_options.event_notifications, 0, sizeof(EventNotificationList));
+
+	memcpy(&config_file_options, &cached_options, sizeof(t_configuration_options));
+
+	for (i = 0; i < header.tablespace_count; i++)
+	{
+		TablespaceListCell *cell = (TablespaceListCell *) pg_malloc0(sizeof(TablespaceListCell));
+
+		strncpy(cell->old_dir, tablespace_cells[i].old_dir, MAXPGPATH);
+		strncpy(cell->new_dir, tablespace_cells[i].new_dir, MAXPGPATH);
+
+		if (config_file_options.tablespace_mapping.tail)
+			config_file_options.tablespace_mapping.tail->next = cell;
+		else
+			config_file_options.tablespace_mapping.head = cell;
+
+		config_file_options.tablespace_mapping.tail = cell;
+	}
+
+	for (i = 0; i < header.event_notification_count; i++)
+	{
+		EventNotificationListCell *cell = (EventNotificationListCell *) pg_malloc0(sizeof(EventNotificationListCell));
+
+		strncpy(cell->event_type, event_cells[i].event_type, MAXLEN);
+
+		if (config_file_options.event_notifications.tail)
+			config_file_options.event_notifications.tail->next = cell;
+		else
+			config_file_options.event_notifications.head = cell;
+
+		config_file_options.event_notifications.tail = cell;
+	}
+
+	if (tablespace_cells != NULL)
+		pg_free(tablespace_cells);
+
+	if (event_cells != NULL)
+		pg_free(event_cells);
+
+	log_verbose(LOG_DEBUG, "configuration loaded from cache file \"%s\"",
+				cache_file_path);
+
+	config_file_parsed_from_cache = true;
+
+	return true;
+}
+
+
+/*
+ * Write the current (successfully parsed and validated) configuration to
+ * the binary cache file. Best-effort: the configuration file's directory
+ * may not be writable by the current user, in which case the cache is
+ * simply not used.
+ */
+static void
+write_config_file_cache(void)
+{
+	char		cache_file_path[MAXPGPATH + sizeof(CONFIG_CACHE_SUFFIX)] = "";
+	char		tmp_file_path[MAXPGPATH + sizeof(CONFIG_CACHE_SUFFIX) + 16] = "";
+	struct stat statbuf;
+	int			fd;
+	FILE	   *fp;
+	t_config_cache_header header;
+	TablespaceListCell *tablespace_cell = NULL;
+	EventNotificationListCell *event_cell = NULL;
+	bool		write_ok = true;
+
+	if (getenv("REPMGR_NO_CONFIG_CACHE") != NULL)
+		return;
+
+	if (stat(config_file_path, &statbuf) != 0)
+		return;
+
+	memset(&header, 0, sizeof(t_config_cache_header));
+
+	header.magic = CONFIG_CACHE_MAGIC;
+	header.version_num = REPMGR_VERSION_NUM;
+	header.options_size = sizeof(t_configuration_options);
+	header.config_dev = statbuf.st_dev;
+	header.config_ino = statbuf.st_ino;
+	header.config_size = statbuf.st_size;
+	header.config_mtime = statbuf.st_mtime;
+
+	for (tablespace_cell = config_file_options.tablespace_mapping.head;
+		 tablespace_cell != NULL;
+		 tablespace_cell = tablespace_cell->next)
+	{
+		header.tablespace_count++;
+	}
+
+	for (event_cell = config_file_options.event_notifications.head;
+		 event_cell != NULL;
+		 event_cell = event_cell->next)
+	{
+		header.event_notification_count++;
+	}
+
+	snprintf(cache_file_path, sizeof(cache_file_path),
+			 "%s%s",
+			 config_file_path,
+			 CONFIG_CACHE_SUFFIX);
+
+	snprintf(tmp_file_path, sizeof(tmp_file_path),
+			 "%s.tmp.%i",
+			 cache_file_path,
+			 (int) getpid());
+
+	/*
+	 * The cache may contain sensitive values (e.g. a conninfo password),
+	 * so restrict it to the owner.
+	 */
+	fd = open(tmp_file_path, O_WRONLY | O_CREAT | O_TRUNC, 0600);
+
+	if (fd < 0)
+	{
+		log_debug("unable to create configuration cache file \"%s\": %s",
+				  tmp_file_path, strerror(errno));
+		return;
+	}
+
+	fp = fdopen(fd, "w");
+
+	if (fp == NULL)
+	{
+		close(fd);
+		unlink(tmp_file_path);
+		return;
+	}
+
+	if (fwrite(&header, sizeof(t_config_cache_header), 1, fp) != 1)
+		write_ok = false;
+
+	if (write_ok == true &&
+		fwrite(&config_file_options, sizeof(t_configuration_options), 1, fp) != 1)
+		write_ok = false;
+
+	for (tablespace_cell = config_file_options.tablespace_mapping.head;
+		 write_ok == true && tablespace_cell != NULL;
+		 tablespace_cell = tablespace_cell->next)
+	{
+		if (fwrite(tablespace_cell, sizeof(TablespaceListCell), 1, fp) != 1)
+			write_ok = false;
+	}
+
+	for (event_cell = config_file_options.event_notifications.head;
+		 write_ok == true && event_cell != NULL;
+		 event_cell = event_cell->next)
+	{
+		if (fwrite(event_cell, sizeof(EventNotificationListCell), 1, fp) != 1)
+			write_ok = false;
+	}
+
+	if (fclose(fp) != 0)
+		write_ok = false;
+
+	if (write_ok == false || rename(tmp_file_path, cache_file_path) != 0)
+	{
+		log_debug("unable to write configuration cache file \"%s\": %s",
+				  cache_file_path, strerror(errno));
+		unlink(tmp_file_path);
+		return;
+	}
+
+	log_verbose(LOG_DEBUG, "configuration cache written to \"%s\"",
+				cache_file_path);
+}
+
+
 void
 parse_configuration_item(ItemList *error_list, ItemList *warning_list, const char *name, const char *value)
 {
@@ -849,6 +1187,7 @@ parse_time_unit_parameter(const char *name, const char *value, char *dest, ItemL
  * - child_nodes_connected_min_count
  * - child_nodes_connected_include_witness
  * - child_nodes_disconnect_command
+ * - child_nodes_disconnect_command_timeout
  * - child_nodes_disconnect_min_count
  * - child_nodes_disconnect_timeout
  * - connection_check_type
@@ -894,9 +1233,14 @@ parse_time_unit_parameter(const char *name, const char *value, char *dest, ItemL
  *	 grep config_file_options\\. repmgrd*.c | perl -n -e '/config_file_options\.([\w_]+)/ && print qq|$1\n|;' | sort | uniq
  *
  * Returns "true" if the configuration was successfully changed, otherwise "false".
+ *
+ * "conninfo_changed", if provided, is set to "true" if (and only if) the
+ * "conninfo" string was changed, so the caller can determine whether the
+ * database connection needs to be re-established; changes to any other
+ * parameter take effect without requiring a new connection.
  */
 bool
-reload_config(t_server_type server_type)
+reload_config(t_server_type server_type, bool *conninfo_changed)
 {
 	bool		log_config_changed = false;
 
@@ -906,6 +1250,9 @@ reload_config(t_server_type server_type)
 
 	t_configuration_options orig_config_file_options;
 
+	if (conninfo_changed != NULL)
+		*conninfo_changed = false;
+
 	copy_config_file_options(&config_file_options, &orig_config_file_options);
 
 	log_info(_("reloading configuration file"));
@@ -976,6 +1323,9 @@ reload_config(t_server_type server_type)
 									_("\"conninfo\" changed from \"%s\" to \"%s\""),
 									orig_config_file_options.conninfo,
 									config_file_options.conninfo);
+
+			if (conninfo_changed != NULL)
+				*conninfo_changed = true;
 		}
 
 		PQfinish(conn);
@@ -1011,6 +1361,9 @@ reload_config(t_server_type server_type)
 
 		copy_config_file_options(&orig_config_file_options, &config_file_options);
 
+		if (conninfo_changed != NULL)
+			*conninfo_changed = false;
+
 		return false;
 	}
 
@@ -1086,6 +1439,15 @@ reload_config(t_server_type server_type)
 								config_file_options.child_nodes_disconnect_timeout);
 	}
 
+	/* child_nodes_disconnect_command_timeout */
+	if (config_file_options.child_nodes_disconnect_command_timeout != orig_config_file_options.child_nodes_disconnect_command_timeout)
+	{
+		item_list_append_format(&config_changes,
+								_("\"child_nodes_disconnect_command_timeout\" changed from \"%i\" to \"%i\""),
+								orig_config_file_options.child_nodes_disconnect_command_timeout,
+								config_file_options.child_nodes_disconnect_command_timeout);
+	}
+
 
 	/* degraded_monitoring_timeout */
 	if (config_file_options.degraded_monitoring_timeout != orig_config_file_options.degraded_monitoring_timeout)
@@ -1269,6 +1631,7 @@ reload_config(t_server_type server_type)
 								_("\"log_facility\" changed from \"%s\" to \"%s\""),
 								orig_config_file_options.log_facility,
 								config_file_options.log_facility);
+		log_config_changed = true;
 	}
 
 	/* log_file */
@@ -1278,6 +1641,7 @@ reload_config(t_server_type server_type)
 								_("\"log_file\" changed from \"%s\" to \"%s\""),
 								orig_config_file_options.log_file,
 								config_file_options.log_file);
+		log_config_changed = true;
 	}
 
 
@@ -1288,6 +1652,7 @@ reload_config(t_server_type server_type)
 								_("\"log_level\" changed from \"%s\" to \"%s\""),
 								orig_config_file_options.log_level,
 								config_file_options.log_level);
+		log_config_changed = true;
 	}
 
 	/* log_status_interval */
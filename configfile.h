@@ -35,6 +35,7 @@
 #define PG_AUTOCONF_FILENAME "postgresql.auto.conf"
 
 extern bool config_file_found;
+extern bool config_file_include_processed;
 extern char config_file_path[MAXPGPATH];
 
 typedef enum
@@ -145,6 +146,7 @@ typedef struct
 	char		log_facility[MAXLEN];
 	char		log_file[MAXPGPATH];
 	int			log_status_interval;
+	bool		log_async;
 
 	/* standby clone settings */
 	bool		use_replication_slots;
@@ -177,6 +179,7 @@ typedef struct
 	/* node check settings */
 	int			archive_ready_warning;
 	int			archive_ready_critical;
+	int			archive_ready_cache_ttl;
 	int			replication_lag_warning;
 	int			replication_lag_critical;
 
@@ -198,6 +201,7 @@ typedef struct
 	int			primary_notification_timeout;
 	int			repmgrd_standby_startup_timeout;
 	char		repmgrd_pid_file[MAXPGPATH];
+	char		repmgrd_metrics_file[MAXPGPATH];
 	bool		standby_disconnect_on_failover;
 	int			sibling_nodes_disconnect_timeout;
 	ConnectionCheckType connection_check_type;
@@ -211,6 +215,7 @@ typedef struct
 	bool		child_nodes_connected_include_witness;
 	int			child_nodes_disconnect_timeout;
 	char		child_nodes_disconnect_command[MAXPGPATH];
+	int			child_nodes_disconnect_command_timeout;
 
 	/* service settings */
 	char		pg_ctl_options[MAXLEN];
@@ -312,7 +317,7 @@ void		set_progname(const char *argv0);
 const char *progname(void);
 
 void		load_config(const char *config_file, bool verbose, bool terse, char *argv0);
-bool		reload_config(t_server_type server_type);
+bool		reload_config(t_server_type server_type, bool *conninfo_changed);
 void		dump_config(void);
 
 void		parse_configuration_item(ItemList *error_list, ItemList *warning_list, const char *name, const char *value);
@@ -0,0 +1,288 @@
+#!/bin/bash
+#
+# failover-benchmark.sh
+# Copyright (c) 2ndQuadrant, 2010-2020
+#
+# Failover latency benchmark harness.
+#
+# Provisions a throwaway N-node replication cluster on localhost (one
+# primary, N-1 standbys) using "repmgr primary register" / "repmgr standby
+# clone" / "repmgr standby register", starts repmgrd on each node, then
+# kills the primary with SIGKILL and measures how long the cluster takes
+# to recover:
+#
+#   - promotion latency:     primary kill -> "repmgrd_failover_promote"
+#                            event recorded by the promotion candidate
+#   - reconvergence latency: primary kill -> last "repmgrd_failover_follow"
+#                            event recorded by the remaining standbys
+#
+# In addition, the per-phase timing histograms published by repmgrd
+# (election, failover - see "repmgr service status --timings") are dumped
+# from the new primary after each run.
+#
+# The cluster is re-provisioned from scratch for every run, so runs are
+# independent and results are comparable across code changes.
+#
+# Requires PostgreSQL binaries (initdb, pg_ctl, psql) and the repmgr and
+# repmgrd binaries in $PATH (or set PG_BINDIR / REPMGR_BINDIR).
+#
+# Usage:
+#   failover-benchmark.sh [-n nodes] [-r runs] [-p base_port] [-d workdir]
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+set -u
+
+NODES=3
+RUNS=3
+BASE_PORT=54320
+WORKDIR=$(pwd)/failover-benchmark
+PROMOTION_TIMEOUT=60
+RECONVERGENCE_TIMEOUT=60
+
+PG_BINDIR=${PG_BINDIR:-}
+REPMGR_BINDIR=${REPMGR_BINDIR:-}
+
+while getopts "n:r:p:d:h" opt; do
+	case "$opt" in
+		n) NODES=$OPTARG ;;
+		r) RUNS=$OPTARG ;;
+		p) BASE_PORT=$OPTARG ;;
+		d) WORKDIR=$OPTARG ;;
+		h)
+			echo "Usage: $0 [-n nodes] [-r runs] [-p base_port] [-d workdir]"
+			exit 0
+			;;
+		*) exit 1 ;;
+	esac
+done
+
+if [ "$NODES" -lt 2 ]; then
+	echo "ERROR: at least 2 nodes required" >&2
+	exit 1
+fi
+
+[ -n "$PG_BINDIR" ] && PATH=$PG_BINDIR:$PATH
+[ -n "$REPMGR_BINDIR" ] && PATH=$REPMGR_BINDIR:$PATH
+
+for prog in initdb pg_ctl psql repmgr repmgrd; do
+	if ! command -v $prog >/dev/null 2>&1; then
+		echo "ERROR: \"$prog\" not found in \$PATH" >&2
+		exit 1
+	fi
+done
+
+node_port()    { echo $((BASE_PORT + $1)); }
+node_datadir() { echo "$WORKDIR/node$1/data"; }
+node_conf()    { echo "$WORKDIR/node$1/repmgr.conf"; }
+node_log()     { echo "$WORKDIR/node$1/repmgrd.log"; }
+
+# major version of the PostgreSQL binaries in $PATH, e.g. "12" or "9" (for 9.x)
+pg_major_version() { initdb --version | sed -E 's/^[^0-9]*([0-9]+).*/\1/'; }
+
+run_psql()
+{
+	# run_psql <node> <query>
+	psql -X -q -A -t -h localhost -p "$(node_port "$1")" -U repmgr -d repmgr -c "$2" 2>/dev/null
+}
+
+write_repmgr_conf()
+{
+	local i=$1
+
+	cat > "$(node_conf "$i")" <<-EOF
+		node_id=$i
+		node_name='node$i'
+		conninfo='host=localhost port=$(node_port "$i") user=repmgr dbname=repmgr connect_timeout=2'
+		data_directory='$(node_datadir "$i")'
+		failover='automatic'
+		promote_command='repmgr standby promote -f $(node_conf "$i") --log-to-file'
+		follow_command='repmgr standby follow -f $(node_conf "$i") --log-to-file --upstream-node-id=%n'
+		monitor_interval_secs=1
+		reconnect_attempts=2
+		reconnect_interval=1
+		repmgrd_pid_file='$WORKDIR/node$i/repmgrd.pid'
+		log_file='$(node_log "$i")'
+	EOF
+}
+
+setup_cluster()
+{
+	local i
+	local wal_keep_setting
+
+	rm -rf "$WORKDIR"
+	mkdir -p "$WORKDIR"
+
+	for i in $(seq 1 "$NODES"); do
+		mkdir -p "$WORKDIR/node$i"
+		write_repmgr_conf "$i"
+	done
+
+	initdb -D "$(node_datadir 1)" -U repmgr --auth=trust >/dev/null 2>&1 || return 1
+
+	# "wal_keep_segments" was replaced by "wal_keep_size" in PostgreSQL 13,
+	# and an unknown parameter in postgresql.conf prevents server startup
+	if [ "$(pg_major_version)" -ge 13 ]; then
+		wal_keep_setting="wal_keep_size = '512MB'"
+	else
+		wal_keep_setting="wal_keep_segments = 32"
+	fi
+
+	cat >> "$(node_datadir 1)/postgresql.conf" <<-EOF
+		port = $(node_port 1)
+		shared_preload_libraries = 'repmgr'
+		wal_level = replica
+		hot_standby = on
+		max_wal_senders = 10
+		max_replication_slots = 10
+		$wal_keep_setting
+		listen_addresses = 'localhost'
+	EOF
+
+	pg_ctl -w -D "$(node_datadir 1)" -l "$WORKDIR/node1/postgres.log" start >/dev/null || return 1
+
+	psql -X -q -h localhost -p "$(node_port 1)" -U repmgr -d postgres \
+		 -c "CREATE DATABASE repmgr OWNER repmgr" >/dev/null || return 1
+
+	repmgr -f "$(node_conf 1)" primary register >/dev/null 2>&1 || return 1
+
+	for i in $(seq 2 "$NODES"); do
+		repmgr -f "$(node_conf "$i")" standby clone \
+			   -h localhost -p "$(node_port 1)" -U repmgr -d repmgr >/dev/null 2>&1 || return 1
+
+		echo "port = $(node_port "$i")" >> "$(node_datadir "$i")/postgresql.conf"
+
+		pg_ctl -w -D "$(node_datadir "$i")" -l "$WORKDIR/node$i/postgres.log" start >/dev/null || return 1
+
+		repmgr -f "$(node_conf "$i")" standby register >/dev/null 2>&1 || return 1
+	done
+
+	for i in $(seq 1 "$NODES"); do
+		repmgrd -f "$(node_conf "$i")" -d >/dev/null 2>&1 || return 1
+	done
+
+	# allow repmgrd on each node to settle into its monitoring loop
+	sleep 3
+
+	return 0
+}
+
+teardown_cluster()
+{
+	local i pidfile
+
+	for i in $(seq 1 "$NODES"); do
+		pidfile=$WORKDIR/node$i/repmgrd.pid
+		[ -f "$pidfile" ] && kill "$(cat "$pidfile")" 2>/dev/null
+
+		if [ -d "$(node_datadir "$i")" ]; then
+			pg_ctl -D "$(node_datadir "$i")" -m immediate stop >/dev/null 2>&1
+		fi
+	done
+
+	sleep 1
+	rm -rf "$WORKDIR"
+}
+
+# epoch seconds (fractional) of an event recorded on the given node
+event_epoch()
+{
+	# event_epoch <node> <event> <min|max>
+	run_psql "$1" "SELECT $3(EXTRACT(EPOCH FROM event_timestamp)) FROM repmgr.events WHERE event = '$2'"
+}
+
+benchmark_run()
+{
+	local run=$1
+	local i kill_epoch promote_epoch follow_epoch new_primary_id=""
+	local elapsed expected_follows
+
+	if ! setup_cluster; then
+		echo "ERROR: run $run: cluster setup failed (see $WORKDIR)" >&2
+		return 1
+	fi
+
+	kill_epoch=$(date +%s.%N)
+	kill -9 "$(head -1 "$(node_datadir 1)/postmaster.pid")"
+
+	# wait for one of the standbys to promote itself
+	elapsed=0
+	while [ "$elapsed" -lt "$PROMOTION_TIMEOUT" ]; do
+		for i in $(seq 2 "$NODES"); do
+			if [ "$(run_psql "$i" "SELECT COUNT(*) FROM repmgr.events WHERE event = 'repmgrd_failover_promote'")" = "1" ]; then
+				new_primary_id=$i
+				break 2
+			fi
+		done
+		sleep 1
+		elapsed=$((elapsed + 1))
+	done
+
+	if [ -z "$new_primary_id" ]; then
+		echo "ERROR: run $run: no promotion after ${PROMOTION_TIMEOUT}s (see $WORKDIR)" >&2
+		return 1
+	fi
+
+	promote_epoch=$(event_epoch "$new_primary_id" "repmgrd_failover_promote" "min")
+
+	# wait for the remaining standbys to report they are following the new primary
+	expected_follows=$((NODES - 2))
+	follow_epoch=$promote_epoch
+
+	if [ "$expected_follows" -gt 0 ]; then
+		elapsed=0
+		while [ "$elapsed" -lt "$RECONVERGENCE_TIMEOUT" ]; do
+			if [ "$(run_psql "$new_primary_id" "SELECT COUNT(*) FROM repmgr.events WHERE event = 'repmgrd_failover_follow'")" = "$expected_follows" ]; then
+				break
+			fi
+			sleep 1
+			elapsed=$((elapsed + 1))
+		done
+
+		follow_epoch=$(event_epoch "$new_primary_id" "repmgrd_failover_follow" "max")
+
+		if [ -z "$follow_epoch" ]; then
+			echo "ERROR: run $run: no reconvergence after ${RECONVERGENCE_TIMEOUT}s (see $WORKDIR)" >&2
+			return 1
+		fi
+	fi
+
+	printf "run %i: new primary: node%i; promotion: %.2fs; reconvergence: %.2fs\n" \
+		   "$run" "$new_primary_id" \
+		   "$(echo "$promote_epoch $kill_epoch" | awk '{print $1 - $2}')" \
+		   "$(echo "$follow_epoch $kill_epoch" | awk '{print $1 - $2}')"
+
+	# dump the phase timings recorded by the new primary's repmgrd
+	timings=$(run_psql "$new_primary_id" "SELECT repmgr.get_repmgrd_timings()")
+	if [ -n "$timings" ]; then
+		echo "$timings" | grep -E '^(election|failover):' | sed 's/^/    /'
+	fi
+
+	teardown_cluster
+
+	return 0
+}
+
+echo "failover benchmark: $NODES nodes, $RUNS run(s), workdir: $WORKDIR"
+
+trap teardown_cluster EXIT
+
+failed=0
+
+for run in $(seq 1 "$RUNS"); do
+	benchmark_run "$run" || failed=1
+done
+
+exit $failed
@@ -83,6 +83,20 @@ get_pg_version(const char *data_directory, char *version_string)
 }
 
 
+/*
+ * Read pg_control once and return a snapshot of the fields repmgr is
+ * interested in. Callers which need several control file values for one
+ * operation should use this rather than the individual accessors below,
+ * each of which re-reads the file. Check "control_file_processed" before
+ * using any other field; the caller should pfree() the result.
+ */
+ControlFileInfo *
+get_controlfile_snapshot(const char *data_directory)
+{
+	return get_controlfile(data_directory);
+}
+
+
 uint64
 get_system_identifier(const char *data_directory)
 {
@@ -135,6 +149,23 @@ get_latest_checkpoint_location(const char *data_directory)
 }
 
 
+uint32
+get_wal_segment_size(const char *data_directory)
+{
+	ControlFileInfo *control_file_info = NULL;
+	uint32		xlog_seg_size = 0;
+
+	control_file_info = get_controlfile(data_directory);
+
+	if (control_file_info->control_file_processed == true)
+		xlog_seg_size = control_file_info->xlog_seg_size;
+
+	pfree(control_file_info);
+
+	return xlog_seg_size;
+}
+
+
 int
 get_data_checksum_version(const char *data_directory)
 {
@@ -250,6 +281,7 @@ get_controlfile(const char *DataDir)
 	control_file_info->timeline = -1;
 	control_file_info->minRecoveryPointTLI = -1;
 	control_file_info->minRecoveryPoint = InvalidXLogRecPtr;
+	control_file_info->xlog_seg_size = 0;
 
 	/*
 	 * Read PG_VERSION, as we'll need to determine which struct to read
@@ -332,6 +364,7 @@ get_controlfile(const char *DataDir)
 		control_file_info->timeline = ptr->checkPointCopy.ThisTimeLineID;
 		control_file_info->minRecoveryPointTLI = ptr->minRecoveryPointTLI;
 		control_file_info->minRecoveryPoint = ptr->minRecoveryPoint;
+		control_file_info->xlog_seg_size = ptr->xlog_seg_size;
 #else
 		fprintf(stderr, "ERROR: please use a repmgr version built for PostgreSQL 12\n");
 		exit(ERR_BAD_CONFIG);
@@ -347,6 +380,7 @@ get_controlfile(const char *DataDir)
 		control_file_info->timeline = ptr->checkPointCopy.ThisTimeLineID;
 		control_file_info->minRecoveryPointTLI = ptr->minRecoveryPointTLI;
 		control_file_info->minRecoveryPoint = ptr->minRecoveryPoint;
+		control_file_info->xlog_seg_size = ptr->xlog_seg_size;
 	}
 	else if (version_num >= 90500)
 	{
@@ -358,6 +392,7 @@ get_controlfile(const char *DataDir)
 		control_file_info->timeline = ptr->checkPointCopy.ThisTimeLineID;
 		control_file_info->minRecoveryPointTLI = ptr->minRecoveryPointTLI;
 		control_file_info->minRecoveryPoint = ptr->minRecoveryPoint;
+		control_file_info->xlog_seg_size = ptr->xlog_seg_size;
 	}
 	else if (version_num >= 90400)
 	{
@@ -369,6 +404,7 @@ get_controlfile(const char *DataDir)
 		control_file_info->timeline = ptr->checkPointCopy.ThisTimeLineID;
 		control_file_info->minRecoveryPointTLI = ptr->minRecoveryPointTLI;
 		control_file_info->minRecoveryPoint = ptr->minRecoveryPoint;
+		control_file_info->xlog_seg_size = ptr->xlog_seg_size;
 	}
 
 	pfree(ControlFileDataPtr);
@@ -28,6 +28,7 @@ typedef struct
 	TimeLineID	timeline;
 	TimeLineID	minRecoveryPointTLI;
 	XLogRecPtr	minRecoveryPoint;
+	uint32		xlog_seg_size;
 } ControlFileInfo;
 
 
@@ -377,11 +378,13 @@ typedef struct ControlFileData12
 #endif
 
 extern int get_pg_version(const char *data_directory, char *version_string);
+extern ControlFileInfo *get_controlfile_snapshot(const char *data_directory);
 extern bool get_db_state(const char *data_directory, DBState *state);
 extern const char *describe_db_state(DBState state);
 extern int	get_data_checksum_version(const char *data_directory);
 extern uint64 get_system_identifier(const char *data_directory);
 extern XLogRecPtr get_latest_checkpoint_location(const char *data_directory);
+extern uint32 get_wal_segment_size(const char *data_directory);
 extern TimeLineID get_timeline(const char *data_directory);
 extern TimeLineID get_min_recovery_end_timeline(const char *data_directory);
 extern XLogRecPtr get_min_recovery_location(const char *data_directory);
@@ -18,8 +18,10 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/select.h>
 #include <sys/time.h>
 #include <sys/stat.h>
 #include <dirent.h>
@@ -50,6 +52,9 @@ static PGconn *_get_primary_connection(PGconn *standby_conn, int *primary_id, ch
 static bool _set_config(PGconn *conn, const char *config_param, const char *sqlquery);
 static bool _get_pg_setting(PGconn *conn, const char *setting, char *str_output, bool *bool_output, int *int_output);
 
+static void _build_replication_info_query(PQExpBufferData *query, PGconn *conn, t_server_type node_type);
+static bool _parse_replication_info(PGresult *res, ReplInfo *replication_info);
+
 static RecordStatus _get_node_record(PGconn *conn, char *sqlquery, t_node_info *node_info, bool init_defaults);
 static void _populate_node_record(PGresult *res, t_node_info *node_info, int row, bool init_defaults);
 
@@ -57,6 +62,15 @@ static void _populate_node_records(PGresult *res, NodeInfoList *node_list);
 
 static bool _create_update_node_record(PGconn *conn, char *action, t_node_info *node_info);
 
+static TimeLineHistoryEntry *parse_timeline_history(const char *content, TimeLineID tli);
+static void format_timeline_history_cache_path(char *path, const char *data_directory, TimeLineID tli);
+static char *read_timeline_history_cache(const char *data_directory, TimeLineID tli);
+static void write_timeline_history_cache(const char *data_directory, TimeLineID tli, const char *content);
+
+static int	conninfo_list_element_count(const char *list);
+static void conninfo_list_element(const char *list, int index, char *dest, size_t dest_len);
+static PGconn *_establish_racing_connection(t_conninfo_param_list *param_list, const char *host_list);
+
 static ReplSlotStatus _verify_replication_slot(PGconn *conn, char *slot_name, PQExpBufferData *error_msg);
 
 static bool _create_event(PGconn *conn, t_configuration_options *options, int node_id, char *event, bool successful, char *details, t_event_info *event_info, bool send_notification);
@@ -239,6 +253,478 @@ establish_db_connection_quiet(const char *conninfo)
 }
 
 
+/*
+ * Attempt to open a database connection to each node in the provided list
+ * concurrently, using libpq's nonblocking connection API, so that the
+ * total time taken approximates a single connection attempt rather than
+ * the sum of all attempts (significant when one or more nodes are
+ * unreachable and each connection would otherwise wait out its full
+ * "connect_timeout").
+ *
+ * Each node record's "conn" field is set to the resulting connection
+ * object; as with establish_db_connection_quiet(), no error is emitted
+ * for unreachable nodes, and the caller is responsible for checking
+ * each connection's status and closing it. Nodes which already have a
+ * usable connection are left untouched.
+ *
+ * Note: unlike _establish_db_connection(), this function does not set
+ * "synchronous_commit" on the established connections, as they are
+ * intended for read-only status checks.
+ */
+void
+establish_node_connections_parallel(NodeInfoList *nodes)
+{
+	NodeInfoListCell *cell = NULL;
+	PostgresPollingStatusType *poll_status = NULL;
+	time_t	   *deadline = NULL;
+	PGconn	  **conns = NULL;
+	int			i = 0;
+	int			pending = 0;
+
+	if (nodes->node_count == 0)
+		return;
+
+	poll_status = (PostgresPollingStatusType *) pg_malloc0(sizeof(PostgresPollingStatusType) * nodes->node_count);
+	deadline = (time_t *) pg_malloc0(sizeof(time_t) * nodes->node_count);
+	conns = (PGconn **) pg_malloc0(sizeof(PGconn *) * nodes->node_count);
+
+	/* start all connection attempts */
+	for (cell = nodes->head; cell; cell = cell->next)
+	{
+		t_conninfo_param_list conninfo_params = T_CONNINFO_PARAM_LIST_INITIALIZER;
+		char	   *connection_string = NULL;
+		char	   *errmsg = NULL;
+		char	   *connect_timeout = NULL;
+		int			connect_timeout_secs = 2;
+
+		/* leave any existing usable connection alone */
+		if (cell->node_info->conn != NULL)
+		{
+			if (PQstatus(cell->node_info->conn) == CONNECTION_OK)
+			{
+				poll_status[i] = PGRES_POLLING_OK;
+				i++;
+				continue;
+			}
+
+			/* stale connection - discard before retrying */
+			close_connection(&cell->node_info->conn);
+		}
+
+		initialize_conninfo_params(&conninfo_params, false);
+
+		if (parse_conninfo_string(cell->node_info->conninfo, &conninfo_params, &errmsg, false) == false)
+		{
+			log_verbose(LOG_WARNING, _("unable to parse conninfo string \"%s\""),
+						cell->node_info->conninfo);
+			free_conninfo_params(&conninfo_params);
+			cell->node_info->conn = NULL;
+			poll_status[i] = PGRES_POLLING_FAILED;
+			i++;
+			continue;
+		}
+
+		/* set some default values if not explicitly provided */
+		param_set_ine(&conninfo_params, "connect_timeout", "2");
+		param_set_ine(&conninfo_params, "fallback_application_name", "repmgr");
+
+		/* use a secure search_path */
+		param_set(&conninfo_params, "options", "-csearch_path=");
+
+		/*
+		 * PQconnectPoll() does not enforce "connect_timeout" itself, so
+		 * extract the value and apply it as a deadline in the polling loop.
+		 */
+		connect_timeout = param_get(&conninfo_params, "connect_timeout");
+		if (connect_timeout != NULL && atoi(connect_timeout) > 0)
+			connect_timeout_secs = atoi(connect_timeout);
+
+		connection_string = param_list_to_string(&conninfo_params);
+
+		log_debug(_("connecting to: \"%s\""), connection_string);
+
+		cell->node_info->conn = PQconnectStart(connection_string);
+		conns[i] = cell->node_info->conn;
+		deadline[i] = time(NULL) + connect_timeout_secs;
+
+		if (cell->node_info->conn == NULL || PQstatus(cell->node_info->conn) == CONNECTION_BAD)
+		{
+			poll_status[i] = PGRES_POLLING_FAILED;
+		}
+		else
+		{
+			poll_status[i] = PGRES_POLLING_WRITING;
+			pending++;
+		}
+
+		pfree(connection_string);
+		free_conninfo_params(&conninfo_params);
+
+		i++;
+	}
+
+	/* multiplex the in-progress connection attempts until all complete */
+	while (pending > 0)
+	{
+		fd_set		read_set;
+		fd_set		write_set;
+		struct timeval poll_interval;
+		int			max_fd = -1;
+		time_t		now;
+
+		FD_ZERO(&read_set);
+		FD_ZERO(&write_set);
+
+		for (i = 0; i < nodes->node_count; i++)
+		{
+			int			sock;
+
+			if (poll_status[i] != PGRES_POLLING_READING && poll_status[i] != PGRES_POLLING_WRITING)
+				continue;
+
+			sock = PQsocket(conns[i]);
+
+			if (sock < 0)
+			{
+				poll_status[i] = PGRES_POLLING_FAILED;
+				pending--;
+				continue;
+			}
+
+			if (poll_status[i] == PGRES_POLLING_READING)
+				FD_SET(sock, &read_set);
+			else
+				FD_SET(sock, &write_set);
+
+			if (sock > max_fd)
+				max_fd = sock;
+		}
+
+		if (pending == 0)
+			break;
+
+		/* cap the select() wait so connection deadlines are enforced promptly */
+		poll_interval.tv_sec = 0;
+		poll_interval.tv_usec = 250000;
+
+		if (select(max_fd + 1, &read_set, &write_set, NULL, &poll_interval) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			log_verbose(LOG_WARNING, _("select() failed in establish_node_connections_parallel():\n  %s"),
+						strerror(errno));
+			break;
+		}
+
+		now = time(NULL);
+
+		for (i = 0; i < nodes->node_count; i++)
+		{
+			int			sock;
+
+			if (poll_status[i] != PGRES_POLLING_READING && poll_status[i] != PGRES_POLLING_WRITING)
+				continue;
+
+			sock = PQsocket(conns[i]);
+
+			if ((poll_status[i] == PGRES_POLLING_READING && FD_ISSET(sock, &read_set)) ||
+				(poll_status[i] == PGRES_POLLING_WRITING && FD_ISSET(sock, &write_set)))
+			{
+				poll_status[i] = PQconnectPoll(conns[i]);
+
+				if (poll_status[i] == PGRES_POLLING_OK || poll_status[i] == PGRES_POLLING_FAILED)
+					pending--;
+			}
+			else if (now >= deadline[i])
+			{
+				/* timed out - leave the connection in its failed state */
+				poll_status[i] = PGRES_POLLING_FAILED;
+				pending--;
+			}
+		}
+	}
+
+	pg_free(poll_status);
+	pg_free(deadline);
+	pg_free(conns);
+}
+
+
+/*
+ * Return the number of comma-separated elements in a multi-value conninfo
+ * parameter such as "host" or "port".
+ */
+static int
+conninfo_list_element_count(const char *list)
+{
+	const char *p = NULL;
+	int			count = 1;
+
+	for (p = list; *p != '\0'; p++)
+	{
+		if (*p == ',')
+			count++;
+	}
+
+	return count;
+}
+
+
+/*
+ * Copy the nth comma-separated element of a multi-value conninfo parameter
+ * into the provided buffer. An empty element is copied as an empty string,
+ * which (as with libpq) results in the parameter's default value being used.
+ */
+static void
+conninfo_list_element(const char *list, int index, char *dest, size_t dest_len)
+{
+	const char *start = list;
+	const char *end = NULL;
+	size_t		len;
+
+	while (index > 0 && (start = strchr(start, ',')) != NULL)
+	{
+		start++;
+		index--;
+	}
+
+	if (start == NULL)
+	{
+		dest[0] = '\0';
+		return;
+	}
+
+	end = strchr(start, ',');
+
+	if (end == NULL)
+		end = start + strlen(start);
+
+	len = end - start;
+
+	if (len >= dest_len)
+		len = dest_len - 1;
+
+	memcpy(dest, start, len);
+	dest[len] = '\0';
+}
+
+
+/*
+ * Attempt nonblocking connections to each host in a multi-host conninfo
+ * concurrently, adopting the first connection to be successfully
+ * established and discarding the rest.
+ *
+ * libpq itself tries the listed hosts strictly in order, so when an
+ * earlier host is unreachable (e.g. a black-holed address following a
+ * network partition), every connection attempt waits out that host's
+ * full "connect_timeout" before the next host is even tried; racing the
+ * attempts bounds connection establishment by the fastest live host.
+ *
+ * Returns the winning connection; if no host could be reached, the first
+ * failed connection object is returned so the caller can report its
+ * error message. NULL is returned if the host list could not be raced
+ * at all (e.g. mismatched multi-value parameters), in which case the
+ * caller should fall back to a standard sequential connection attempt.
+ */
+static PGconn *
+_establish_racing_connection(t_conninfo_param_list *param_list, const char *host_list)
+{
+	int			host_count = conninfo_list_element_count(host_list);
+	char	   *port_list = param_get(param_list, "port");
+	char	   *hostaddr_list = param_get(param_list, "hostaddr");
+	char	   *connect_timeout = param_get(param_list, "connect_timeout");
+	int			connect_timeout_secs = 2;
+	PGconn	  **conns = NULL;
+	PostgresPollingStatusType *poll_status = NULL;
+	time_t	   *deadline = NULL;
+	PGconn	   *winner = NULL;
+	PGconn	   *failed_conn = NULL;
+	int			pending = 0;
+	int			i = 0;
+
+	/*
+	 * libpq requires a multi-value "port" or "hostaddr" to have exactly
+	 * as many elements as "host"; if that's not the case, hand the whole
+	 * string back to libpq to generate the standard error.
+	 */
+	if (port_list != NULL && strchr(port_list, ',') != NULL
+		&& conninfo_list_element_count(port_list) != host_count)
+		return NULL;
+
+	if (hostaddr_list != NULL
+		&& conninfo_list_element_count(hostaddr_list) != host_count)
+		return NULL;
+
+	if (connect_timeout != NULL && atoi(connect_timeout) > 0)
+		connect_timeout_secs = atoi(connect_timeout);
+
+	conns = (PGconn **) pg_malloc0(sizeof(PGconn *) * host_count);
+	poll_status = (PostgresPollingStatusType *) pg_malloc0(sizeof(PostgresPollingStatusType) * host_count);
+	deadline = (time_t *) pg_malloc0(sizeof(time_t) * host_count);
+
+	/* start a connection attempt for each listed host */
+	for (i = 0; i < host_count; i++)
+	{
+		t_conninfo_param_list host_params = T_CONNINFO_PARAM_LIST_INITIALIZER;
+		char		element[MAXLEN] = "";
+		char	   *connection_string = NULL;
+
+		initialize_conninfo_params(&host_params, false);
+		copy_conninfo_params(&host_params, param_list);
+
+		conninfo_list_element(host_list, i, element, sizeof(element));
+		param_set(&host_params, "host", element);
+
+		if (port_list != NULL && strchr(port_list, ',') != NULL)
+		{
+			conninfo_list_element(port_list, i, element, sizeof(element));
+			param_set(&host_params, "port", element);
+		}
+
+		if (hostaddr_list != NULL && strchr(hostaddr_list, ',') != NULL)
+		{
+			conninfo_list_element(hostaddr_list, i, element, sizeof(element));
+			param_set(&host_params, "hostaddr", element);
+		}
+
+		connection_string = param_list_to_string(&host_params);
+
+		log_debug(_("racing connection to: \"%s\""), connection_string);
+
+		conns[i] = PQconnectStart(connection_string);
+		deadline[i] = time(NULL) + connect_timeout_secs;
+
+		if (conns[i] == NULL || PQstatus(conns[i]) == CONNECTION_BAD)
+		{
+			poll_status[i] = PGRES_POLLING_FAILED;
+		}
+		else
+		{
+			poll_status[i] = PGRES_POLLING_WRITING;
+			pending++;
+		}
+
+		pfree(connection_string);
+		free_conninfo_params(&host_params);
+	}
+
+	/* multiplex the in-progress attempts until one succeeds or all fail */
+	while (pending > 0 && winner == NULL)
+	{
+		fd_set		read_set;
+		fd_set		write_set;
+		struct timeval poll_interval;
+		int			max_fd = -1;
+		time_t		now;
+
+		FD_ZERO(&read_set);
+		FD_ZERO(&write_set);
+
+		for (i = 0; i < host_count; i++)
+		{
+			int			sock;
+
+			if (poll_status[i] != PGRES_POLLING_READING && poll_status[i] != PGRES_POLLING_WRITING)
+				continue;
+
+			sock = PQsocket(conns[i]);
+
+			if (sock < 0)
+			{
+				poll_status[i] = PGRES_POLLING_FAILED;
+				pending--;
+				continue;
+			}
+
+			if (poll_status[i] == PGRES_POLLING_READING)
+				FD_SET(sock, &read_set);
+			else
+				FD_SET(sock, &write_set);
+
+			if (sock > max_fd)
+				max_fd = sock;
+		}
+
+		if (pending == 0)
+			break;
+
+		/* cap the select() wait so connection deadlines are enforced promptly */
+		poll_interval.tv_sec = 0;
+		poll_interval.tv_usec = 250000;
+
+		if (select(max_fd + 1, &read_set, &write_set, NULL, &poll_interval) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			log_verbose(LOG_WARNING, _("select() failed in _establish_racing_connection():\n  %s"),
+						strerror(errno));
+			break;
+		}
+
+		now = time(NULL);
+
+		for (i = 0; i < host_count; i++)
+		{
+			int			sock;
+
+			if (poll_status[i] != PGRES_POLLING_READING && poll_status[i] != PGRES_POLLING_WRITING)
+				continue;
+
+			sock = PQsocket(conns[i]);
+
+			if ((poll_status[i] == PGRES_POLLING_READING && FD_ISSET(sock, &read_set)) ||
+				(poll_status[i] == PGRES_POLLING_WRITING && FD_ISSET(sock, &write_set)))
+			{
+				poll_status[i] = PQconnectPoll(conns[i]);
+
+				if (poll_status[i] == PGRES_POLLING_OK)
+				{
+					winner = conns[i];
+					conns[i] = NULL;
+					pending--;
+					break;
+				}
+
+				if (poll_status[i] == PGRES_POLLING_FAILED)
+					pending--;
+			}
+			else if (now >= deadline[i])
+			{
+				/* timed out - leave the connection in its failed state */
+				poll_status[i] = PGRES_POLLING_FAILED;
+				pending--;
+			}
+		}
+	}
+
+	/*
+	 * Discard the losing connection attempts; if no host won, retain the
+	 * first failed connection so its error message can be reported.
+	 */
+	for (i = 0; i < host_count; i++)
+	{
+		if (conns[i] == NULL)
+			continue;
+
+		if (winner == NULL && failed_conn == NULL)
+		{
+			failed_conn = conns[i];
+			continue;
+		}
+
+		PQfinish(conns[i]);
+	}
+
+	pg_free(poll_status);
+	pg_free(deadline);
+	pg_free(conns);
+
+	return winner != NULL ? winner : failed_conn;
+}
+
+
 PGconn *
 establish_db_connection_with_replacement_param(const char *conninfo,
 											   const char *param,
@@ -301,6 +787,7 @@ establish_db_connection_by_params(t_conninfo_param_list *param_list,
 								  const bool exit_on_error)
 {
 	PGconn	   *conn = NULL;
+	char	   *host_list = NULL;
 
 	/* set some default values if not explicitly provided */
 	param_set_ine(param_list, "connect_timeout", "2");
@@ -309,8 +796,19 @@ establish_db_connection_by_params(t_conninfo_param_list *param_list,
 	/* use a secure search_path */
 	param_set(param_list, "options", "-csearch_path=");
 
+	/*
+	 * If multiple hosts are specified, race concurrent connection attempts
+	 * to all of them rather than letting libpq try each host in turn (see
+	 * _establish_racing_connection()).
+	 */
+	host_list = param_get(param_list, "host");
+
+	if (host_list != NULL && strchr(host_list, ',') != NULL)
+		conn = _establish_racing_connection(param_list, host_list);
+
 	/* Connect to the database using the provided parameters */
-	conn = PQconnectdbParams((const char **) param_list->keywords, (const char **) param_list->values, true);
+	if (conn == NULL)
+		conn = PQconnectdbParams((const char **) param_list->keywords, (const char **) param_list->values, true);
 
 	/* Check to see that the backend connection was successfully made */
 	if ((PQstatus(conn) != CONNECTION_OK))
@@ -996,33 +1494,138 @@ rollback_transaction(PGconn *conn)
 }
 
 
-/* ========================== */
-/* GUC manipulation functions */
-/* ========================== */
+/* ========================= */
+/* query batching functions  */
+/* ========================= */
 
-static bool
-_set_config(PGconn *conn, const char *config_param, const char *sqlquery)
+/*
+ * Execute a batch of queries over a single connection, using libpq's
+ * pipeline mode where available (libpq 14 and later) so the whole batch
+ * is sent and its results collected in a single network round trip.
+ * With older libpq versions the queries are executed serially.
+ *
+ * "results" must point to an array with at least "query_count" entries;
+ * on return each entry contains the corresponding query's result (or NULL
+ * if the query could not be submitted), which the caller must free with
+ * PQclear().
+ *
+ * Returns true if all queries executed successfully.
+ */
+bool
+execute_query_batch(PGconn *conn, int query_count, const char *const *queries, PGresult **results)
 {
+	int			i;
 	bool		success = true;
-	PGresult   *res = PQexec(conn, sqlquery);
 
-	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	for (i = 0; i < query_count; i++)
+		results[i] = NULL;
+
+#ifdef LIBPQ_HAS_PIPELINING
+	if (PQenterPipelineMode(conn) == 1)
 	{
-		log_db_error(conn, sqlquery, "_set_config(): unable to set \"%s\"", config_param);
-		success = false;
-	}
+		PGresult   *res = NULL;
+		int			sent_count = 0;
 
-	PQclear(res);
+		for (i = 0; i < query_count; i++)
+		{
+			log_verbose(LOG_DEBUG, "execute_query_batch():\n  %s", queries[i]);
 
-	return success;
-}
+			if (PQsendQueryParams(conn, queries[i], 0, NULL, NULL, NULL, NULL, 0) == 0)
+			{
+				log_warning(_("execute_query_batch(): unable to submit query"));
+				log_detail("%s", PQerrorMessage(conn));
+				success = false;
+				break;
+			}
 
+			sent_count++;
+		}
 
-bool
-set_config(PGconn *conn, const char *config_param, const char *config_value)
-{
-	PQExpBufferData query;
-	bool		result = false;
+		if (PQpipelineSync(conn) == 0)
+		{
+			log_warning(_("execute_query_batch(): unable to send pipeline sync"));
+			log_detail("%s", PQerrorMessage(conn));
+
+			(void) PQexitPipelineMode(conn);
+			return false;
+		}
+
+		/* collect one result set per submitted query */
+		for (i = 0; i < sent_count; i++)
+		{
+			results[i] = PQgetResult(conn);
+
+			if (results[i] == NULL)
+				break;
+
+			if (PQresultStatus(results[i]) != PGRES_TUPLES_OK &&
+				PQresultStatus(results[i]) != PGRES_COMMAND_OK)
+			{
+				success = false;
+			}
+
+			/* consume the NULL terminating this query's results */
+			while ((res = PQgetResult(conn)) != NULL)
+				PQclear(res);
+		}
+
+		/* consume the PGRES_PIPELINE_SYNC result */
+		while ((res = PQgetResult(conn)) != NULL)
+			PQclear(res);
+
+		(void) PQexitPipelineMode(conn);
+
+		return success;
+	}
+
+	/* unable to enter pipeline mode - fall through to serial execution */
+	log_verbose(LOG_DEBUG, "execute_query_batch(): unable to enter pipeline mode, executing serially");
+#endif							/* LIBPQ_HAS_PIPELINING */
+
+	for (i = 0; i < query_count; i++)
+	{
+		log_verbose(LOG_DEBUG, "execute_query_batch():\n  %s", queries[i]);
+
+		results[i] = PQexec(conn, queries[i]);
+
+		if (PQresultStatus(results[i]) != PGRES_TUPLES_OK &&
+			PQresultStatus(results[i]) != PGRES_COMMAND_OK)
+		{
+			success = false;
+		}
+	}
+
+	return success;
+}
+
+
+/* ========================== */
+/* GUC manipulation functions */
+/* ========================== */
+
+static bool
+_set_config(PGconn *conn, const char *config_param, const char *sqlquery)
+{
+	bool		success = true;
+	PGresult   *res = PQexec(conn, sqlquery);
+
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		log_db_error(conn, sqlquery, "_set_config(): unable to set \"%s\"", config_param);
+		success = false;
+	}
+
+	PQclear(res);
+
+	return success;
+}
+
+
+bool
+set_config(PGconn *conn, const char *config_param, const char *config_value)
+{
+	PQExpBufferData query;
+	bool		result = false;
 
 	initPQExpBuffer(&query);
 	appendPQExpBuffer(&query,
@@ -1403,12 +2006,14 @@ get_recovery_type(PGconn *conn)
 }
 
 /*
- * Read the node list from the provided connection and attempt to connect to each node
- * in turn to definitely establish if it's the cluster primary.
+ * Read the node list from the provided connection and check each node to
+ * definitely establish which is the cluster primary.
  *
- * The node list is returned in the order which makes it likely that the
- * current primary will be returned first, reducing the number of speculative
- * connections which need to be made to other nodes.
+ * Connections to all candidate nodes are opened concurrently, bounding
+ * discovery at roughly one connect-plus-query time regardless of how many
+ * candidates are unreachable; the nodes are then checked in the order
+ * which makes it likely that the current primary will be found first, and
+ * the remaining speculative connections discarded.
  *
  * If primary_conninfo_out points to allocated memory of MAXCONNINFO in length,
  * the primary server's conninfo string will be copied there.
@@ -1423,6 +2028,9 @@ _get_primary_connection(PGconn *conn,
 	PGconn	   *remote_conn = NULL;
 	PGresult   *res = NULL;
 
+	NodeInfoList candidate_nodes = T_NODE_INFO_LIST_INITIALIZER;
+	NodeInfoListCell *cell = NULL;
+
 	char		remote_conninfo_stack[MAXCONNINFO];
 	char	   *remote_conninfo = &*remote_conninfo_stack;
 
@@ -1469,63 +2077,81 @@ _get_primary_connection(PGconn *conn,
 
 	termPQExpBuffer(&query);
 
+	/* build a candidate list and connect to all nodes concurrently */
 	for (i = 0; i < PQntuples(res); i++)
+	{
+		NodeInfoListCell *new_cell;
+
+		new_cell = (NodeInfoListCell *) pg_malloc0(sizeof(NodeInfoListCell));
+
+		new_cell->node_info = pg_malloc0(sizeof(t_node_info));
+		new_cell->node_info->node_id = atoi(PQgetvalue(res, i, 0));
+		snprintf(new_cell->node_info->conninfo, MAXLEN, "%s", PQgetvalue(res, i, 1));
+
+		node_info_list_append(&candidate_nodes, new_cell);
+	}
+
+	PQclear(res);
+
+	establish_node_connections_parallel(&candidate_nodes);
+
+	for (cell = candidate_nodes.head; cell; cell = cell->next)
 	{
 		RecoveryType recovery_type;
 
 		/* initialize with the values of the current node being processed */
-		node_id = atoi(PQgetvalue(res, i, 0));
-		snprintf(remote_conninfo, MAXCONNINFO, "%s", PQgetvalue(res, i, 1));
+		node_id = cell->node_info->node_id;
+		snprintf(remote_conninfo, MAXCONNINFO, "%s", cell->node_info->conninfo);
 
 		log_verbose(LOG_INFO,
 					_("checking if node %i is primary"),
 					node_id);
 
-		if (quiet)
-		{
-			remote_conn = establish_db_connection_quiet(remote_conninfo);
-		}
-		else
+		if (PQstatus(cell->node_info->conn) != CONNECTION_OK)
 		{
-			remote_conn = establish_db_connection(remote_conninfo, false);
-		}
+			if (quiet == false)
+			{
+				log_warning(_("unable to connect to node %i"), node_id);
+				log_detail("\n%s", PQerrorMessage(cell->node_info->conn));
+			}
 
-		if (PQstatus(remote_conn) != CONNECTION_OK)
-		{
-			PQfinish(remote_conn);
-			remote_conn = NULL;
+			close_connection(&cell->node_info->conn);
 			continue;
 		}
 
-		recovery_type = get_recovery_type(remote_conn);
+		recovery_type = get_recovery_type(cell->node_info->conn);
 
 		if (recovery_type == RECTYPE_UNKNOWN)
 		{
 			log_warning(_("unable to retrieve recovery state from node %i"),
 						node_id);
 
-			PQfinish(remote_conn);
+			close_connection(&cell->node_info->conn);
 			continue;
 		}
 
 		if (recovery_type == RECTYPE_PRIMARY)
 		{
-			PQclear(res);
 			log_verbose(LOG_INFO, _("current primary node is %i"), node_id);
 
+			/* detach the winning connection; the others are closed below */
+			remote_conn = cell->node_info->conn;
+			cell->node_info->conn = NULL;
+
 			if (primary_id != NULL)
 			{
 				*primary_id = node_id;
 			}
 
-			return remote_conn;
+			break;
 		}
 
-		PQfinish(remote_conn);
+		close_connection(&cell->node_info->conn);
 	}
 
-	PQclear(res);
-	return NULL;
+	clear_node_info_list(&candidate_nodes);
+
+	return remote_conn;
 }
 
 
@@ -1579,8 +2205,21 @@ get_primary_node_id(PGconn *conn)
 
 
 
+/*
+ * Count files pending archiving in the local "archive_status" directory.
+ *
+ * If "max_files" is non-zero, stop scanning once that many ".ready" files
+ * have been seen; callers which only compare the count against a threshold
+ * can pass "threshold + 1" to avoid enumerating a huge backlog (the
+ * directory can accumulate hundreds of thousands of entries when archiving
+ * falls behind, which is exactly when extra I/O load is least welcome).
+ *
+ * If "cache_ttl" is non-zero, a scan result is reused for up to that many
+ * seconds, so repeated checks within one process invocation don't re-scan
+ * the directory.
+ */
 int
-get_ready_archive_files(PGconn *conn, const char *data_directory)
+get_ready_archive_files(PGconn *conn, const char *data_directory, int max_files, int cache_ttl)
 {
 	char		archive_status_dir[MAXPGPATH] = "";
 	struct stat statbuf;
@@ -1589,6 +2228,11 @@ get_ready_archive_files(PGconn *conn, const char *data_directory)
 
 	int			ready_count = 0;
 
+	static char cached_dir[MAXPGPATH] = "";
+	static int	cached_count = 0;
+	static int	cached_max_files = 0;
+	static time_t cached_time = 0;
+
 	if (PQserverVersion(conn) >= 100000)
 	{
 		snprintf(archive_status_dir, MAXPGPATH,
@@ -1602,6 +2246,28 @@ get_ready_archive_files(PGconn *conn, const char *data_directory)
 				 data_directory);
 	}
 
+	/*
+	 * Serve the count from the cache if it's still fresh and was taken with
+	 * a compatible scan limit: an unlimited (or unreached) scan is exact and
+	 * can answer any request; a truncated one can only answer requests with
+	 * the same or a lower cap.
+	 */
+	if (cache_ttl > 0 &&
+		cached_time > 0 &&
+		(time(NULL) - cached_time) < cache_ttl &&
+		strncmp(cached_dir, archive_status_dir, MAXPGPATH) == 0)
+	{
+		bool		cache_is_exact = (cached_max_files == 0 || cached_count < cached_max_files);
+
+		if (cache_is_exact == true || (max_files > 0 && max_files <= cached_max_files))
+		{
+			if (max_files > 0 && cached_count > max_files)
+				return max_files;
+
+			return cached_count;
+		}
+	}
+
 	/* sanity-check directory path */
 	if (stat(archive_status_dir, &statbuf) == -1)
 	{
@@ -1647,11 +2313,22 @@ get_ready_archive_files(PGconn *conn, const char *data_directory)
 		 * implementation see: src/backend/postmaster/pgarch.c
 		 */
 		if (strcmp(arcdir_ent->d_name + basenamelen, ".ready") == 0)
+		{
 			ready_count++;
+
+			/* enough seen to answer the caller's question - stop scanning */
+			if (max_files > 0 && ready_count >= max_files)
+				break;
+		}
 	}
 
 	closedir(arcdir);
 
+	strncpy(cached_dir, archive_status_dir, MAXPGPATH);
+	cached_count = ready_count;
+	cached_max_files = max_files;
+	cached_time = time(NULL);
+
 	return ready_count;
 }
 
@@ -1718,53 +2395,19 @@ system_identifier(PGconn *conn)
 }
 
 
-TimeLineHistoryEntry *
-get_timeline_history(PGconn *repl_conn, TimeLineID tli)
+/*
+ * Extract the entry for timeline "tli - 1" from the content of a timeline
+ * history file; returns NULL if no usable entry was found.
+ */
+static TimeLineHistoryEntry *
+parse_timeline_history(const char *content, TimeLineID tli)
 {
-	PQExpBufferData query;
-	PGresult   *res = NULL;
-
-	PQExpBufferData result;
-	char		*resptr;
+	const char *resptr = content;
 
 	TimeLineHistoryEntry *history;
 	TimeLineID	file_tli = UNKNOWN_TIMELINE_ID;
-	uint32		switchpoint_hi;
-	uint32		switchpoint_lo;
-
-	initPQExpBuffer(&query);
-
-	appendPQExpBuffer(&query,
-					  "TIMELINE_HISTORY %i",
-					  (int)tli);
-
-	res = PQexec(repl_conn, query.data);
-	log_verbose(LOG_DEBUG, "get_timeline_history():\n%s", query.data);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		log_db_error(repl_conn, query.data, _("get_timeline_history(): unable to execute query"));
-		termPQExpBuffer(&query);
-		PQclear(res);
-		return NULL;
-	}
-
-	termPQExpBuffer(&query);
-
-	if (PQntuples(res) != 1 || PQnfields(res) != 2)
-	{
-		log_error(_("unexpected response to TIMELINE_HISTORY command"));
-		log_detail(_("got %i rows and %i fields, expected %i rows and %i fields"),
-				   PQntuples(res), PQnfields(res), 1, 2);
-		PQclear(res);
-		return NULL;
-	}
-
-	initPQExpBuffer(&result);
-	appendPQExpBufferStr(&result, PQgetvalue(res, 0, 1));
-	PQclear(res);
-
-	resptr = result.data;
+	uint32		switchpoint_hi = 0;
+	uint32		switchpoint_lo = 0;
 
 	while (*resptr)
 	{
@@ -1797,12 +2440,10 @@ get_timeline_history(PGconn *repl_conn, TimeLineID tli)
 			resptr++;
 	}
 
-	termPQExpBuffer(&result);
-
 	if (file_tli == UNKNOWN_TIMELINE_ID || file_tli != tli - 1)
 	{
 		log_error(_("timeline %i not found in timeline history file content"), tli);
-		log_detail(_("content is: \"%s\""), result.data);
+		log_detail(_("content is: \"%s\""), content);
 		return NULL;
 	}
 
@@ -1815,6 +2456,192 @@ get_timeline_history(PGconn *repl_conn, TimeLineID tli)
 }
 
 
+static void
+format_timeline_history_cache_path(char *path, const char *data_directory, TimeLineID tli)
+{
+	snprintf(path, MAXPGPATH,
+			 "%s/repmgr/%08X.history",
+			 data_directory,
+			 tli);
+}
+
+
+/*
+ * Return the locally cached content of the history file for the given
+ * timeline, or NULL if not cached; the caller must pfree() the result.
+ */
+static char *
+read_timeline_history_cache(const char *data_directory, TimeLineID tli)
+{
+	char		history_file_path[MAXPGPATH] = "";
+	struct stat statbuf;
+	FILE	   *fp;
+	char	   *content = NULL;
+	size_t		bytes_read = 0;
+
+	format_timeline_history_cache_path(history_file_path, data_directory, tli);
+
+	if (stat(history_file_path, &statbuf) == -1 || !S_ISREG(statbuf.st_mode))
+		return NULL;
+
+	fp = fopen(history_file_path, "r");
+
+	if (fp == NULL)
+		return NULL;
+
+	content = pg_malloc0(statbuf.st_size + 1);
+	bytes_read = fread(content, 1, statbuf.st_size, fp);
+	fclose(fp);
+
+	if (bytes_read != (size_t) statbuf.st_size)
+	{
+		pg_free(content);
+		return NULL;
+	}
+
+	log_verbose(LOG_DEBUG, "read_timeline_history_cache(): timeline %i served from \"%s\"",
+				tli, history_file_path);
+
+	return content;
+}
+
+
+/*
+ * Store fetched history file content in the local cache; best-effort, as
+ * the content can always be re-fetched from the upstream.
+ */
+static void
+write_timeline_history_cache(const char *data_directory, TimeLineID tli, const char *content)
+{
+	char		cache_dir[MAXPGPATH] = "";
+	char		history_file_path[MAXPGPATH] = "";
+	char		tmp_file_path[MAXPGPATH + 16] = "";
+	FILE	   *fp;
+
+	snprintf(cache_dir, MAXPGPATH,
+			 "%s/repmgr",
+			 data_directory);
+
+	if (mkdir(cache_dir, 0700) == -1 && errno != EEXIST)
+	{
+		log_debug("write_timeline_history_cache(): unable to create directory \"%s\": %s",
+				  cache_dir, strerror(errno));
+		return;
+	}
+
+	format_timeline_history_cache_path(history_file_path, data_directory, tli);
+
+	snprintf(tmp_file_path, sizeof(tmp_file_path),
+			 "%s.tmp",
+			 history_file_path);
+
+	fp = fopen(tmp_file_path, "w");
+
+	if (fp == NULL)
+	{
+		log_debug("write_timeline_history_cache(): unable to open \"%s\" for writing: %s",
+				  tmp_file_path, strerror(errno));
+		return;
+	}
+
+	if (fputs(content, fp) == EOF || fclose(fp) != 0)
+	{
+		log_debug("write_timeline_history_cache(): unable to write \"%s\": %s",
+				  tmp_file_path, strerror(errno));
+		unlink(tmp_file_path);
+		return;
+	}
+
+	if (rename(tmp_file_path, history_file_path) != 0)
+	{
+		log_debug("write_timeline_history_cache(): unable to rename \"%s\" to \"%s\": %s",
+				  tmp_file_path, history_file_path, strerror(errno));
+		unlink(tmp_file_path);
+		return;
+	}
+
+	log_verbose(LOG_DEBUG, "write_timeline_history_cache(): timeline %i cached in \"%s\"",
+				tli, history_file_path);
+}
+
+
+/*
+ * Retrieve the timeline history file for the given timeline and extract the
+ * entry for its predecessor timeline.
+ *
+ * History files are immutable once written, so if "local_data_directory" is
+ * provided, fetched content is cached there and subsequent lookups for the
+ * same timeline are served from the cache without requiring a round trip
+ * over the replication connection.
+ */
+TimeLineHistoryEntry *
+get_timeline_history(PGconn *repl_conn, TimeLineID tli, const char *local_data_directory)
+{
+	PQExpBufferData query;
+	PGresult   *res = NULL;
+
+	PQExpBufferData result;
+
+	TimeLineHistoryEntry *history = NULL;
+
+	if (local_data_directory != NULL && local_data_directory[0] != '\0')
+	{
+		char	   *cached_content = read_timeline_history_cache(local_data_directory, tli);
+
+		if (cached_content != NULL)
+		{
+			history = parse_timeline_history(cached_content, tli);
+			pg_free(cached_content);
+
+			/* if the cached content was unusable, fall through and re-fetch */
+			if (history != NULL)
+				return history;
+		}
+	}
+
+	initPQExpBuffer(&query);
+
+	appendPQExpBuffer(&query,
+					  "TIMELINE_HISTORY %i",
+					  (int)tli);
+
+	res = PQexec(repl_conn, query.data);
+	log_verbose(LOG_DEBUG, "get_timeline_history():\n%s", query.data);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		log_db_error(repl_conn, query.data, _("get_timeline_history(): unable to execute query"));
+		termPQExpBuffer(&query);
+		PQclear(res);
+		return NULL;
+	}
+
+	termPQExpBuffer(&query);
+
+	if (PQntuples(res) != 1 || PQnfields(res) != 2)
+	{
+		log_error(_("unexpected response to TIMELINE_HISTORY command"));
+		log_detail(_("got %i rows and %i fields, expected %i rows and %i fields"),
+				   PQntuples(res), PQnfields(res), 1, 2);
+		PQclear(res);
+		return NULL;
+	}
+
+	initPQExpBuffer(&result);
+	appendPQExpBufferStr(&result, PQgetvalue(res, 0, 1));
+	PQclear(res);
+
+	if (local_data_directory != NULL && local_data_directory[0] != '\0')
+		write_timeline_history_cache(local_data_directory, tli, result.data);
+
+	history = parse_timeline_history(result.data, tli);
+
+	termPQExpBuffer(&result);
+
+	return history;
+}
+
+
 /* =============================== */
 /* user/role information functions */
 /* =============================== */
@@ -2159,6 +2986,153 @@ repmgrd_get_pid(PGconn *conn)
 }
 
 
+/*
+ * Store repmgrd's phase timing report in the repmgr extension's shared
+ * memory, from where it can be retrieved with "repmgr daemon status --timings".
+ */
+void
+repmgrd_set_timings(PGconn *conn, const char *timings)
+{
+	PQExpBufferData query;
+	PGresult   *res = NULL;
+	char	   *escaped = escape_string(conn, timings);
+
+	if (escaped == NULL)
+	{
+		log_warning(_("unable to escape timing report"));
+		return;
+	}
+
+	initPQExpBuffer(&query);
+
+	appendPQExpBuffer(&query,
+					  "SELECT repmgr.set_repmgrd_timings('%s')",
+					  escaped);
+
+	pg_free(escaped);
+
+	res = PQexec(conn, query.data);
+	termPQExpBuffer(&query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		log_error(_("unable to execute \"SELECT repmgr.set_repmgrd_timings()\""));
+		log_detail("%s", PQerrorMessage(conn));
+	}
+
+	PQclear(res);
+
+	return;
+}
+
+
+/*
+ * Retrieve the phase timing report last stored by repmgrd; returns false
+ * if no report was available.
+ */
+bool
+repmgrd_get_timings(PGconn *conn, PQExpBufferData *timings)
+{
+	PGresult   *res = NULL;
+	bool		success = true;
+
+	res = PQexec(conn, "SELECT repmgr.get_repmgrd_timings()");
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		log_error(_("unable to execute \"SELECT repmgr.get_repmgrd_timings()\""));
+		log_detail("%s", PQerrorMessage(conn));
+		success = false;
+	}
+	else if (PQgetisnull(res, 0, 0))
+	{
+		success = false;
+	}
+	else
+	{
+		appendPQExpBufferStr(timings, PQgetvalue(res, 0, 0));
+	}
+
+	PQclear(res);
+
+	return success;
+}
+
+
+/*
+ * Store repmgrd's replication lag trend statistics in the repmgr
+ * extension's shared memory, from where they can be retrieved with
+ * "repmgr node check --replication-lag".
+ */
+void
+repmgrd_set_lag_stats(PGconn *conn, const char *lag_stats)
+{
+	PQExpBufferData query;
+	PGresult   *res = NULL;
+	char	   *escaped = escape_string(conn, lag_stats);
+
+	if (escaped == NULL)
+	{
+		log_warning(_("unable to escape replication lag statistics"));
+		return;
+	}
+
+	initPQExpBuffer(&query);
+
+	appendPQExpBuffer(&query,
+					  "SELECT repmgr.set_repmgrd_lag_stats('%s')",
+					  escaped);
+
+	pg_free(escaped);
+
+	res = PQexec(conn, query.data);
+	termPQExpBuffer(&query);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		log_error(_("unable to execute \"SELECT repmgr.set_repmgrd_lag_stats()\""));
+		log_detail("%s", PQerrorMessage(conn));
+	}
+
+	PQclear(res);
+
+	return;
+}
+
+
+/*
+ * Retrieve the replication lag trend statistics last stored by repmgrd;
+ * returns false if none were available.
+ */
+bool
+repmgrd_get_lag_stats(PGconn *conn, PQExpBufferData *lag_stats)
+{
+	PGresult   *res = NULL;
+	bool		success = true;
+
+	res = PQexec(conn, "SELECT repmgr.get_repmgrd_lag_stats()");
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		log_debug(_("unable to execute \"SELECT repmgr.get_repmgrd_lag_stats()\""));
+		log_detail("%s", PQerrorMessage(conn));
+		success = false;
+	}
+	else if (PQgetisnull(res, 0, 0))
+	{
+		success = false;
+	}
+	else
+	{
+		appendPQExpBufferStr(lag_stats, PQgetvalue(res, 0, 0));
+	}
+
+	PQclear(res);
+
+	return success;
+}
+
+
 bool
 repmgrd_is_running(PGconn *conn)
 {
@@ -2854,19 +3828,20 @@ _populate_node_records(PGresult *res, NodeInfoList *node_list)
 	{
 		NodeInfoListCell *cell;
 
-		cell = (NodeInfoListCell *) pg_malloc0(sizeof(NodeInfoListCell));
-
-		cell->node_info = pg_malloc0(sizeof(t_node_info));
+		if (node_list->arena != NULL)
+		{
+			cell = (NodeInfoListCell *) arena_alloc0(node_list->arena, sizeof(NodeInfoListCell));
+			cell->node_info = arena_alloc0(node_list->arena, sizeof(t_node_info));
+		}
+		else
+		{
+			cell = (NodeInfoListCell *) pg_malloc0(sizeof(NodeInfoListCell));
+			cell->node_info = pg_malloc0(sizeof(t_node_info));
+		}
 
 		_populate_node_record(res, cell->node_info, i, true);
 
-		if (node_list->tail)
-			node_list->tail->next = cell;
-		else
-			node_list->head = cell;
-
-		node_list->tail = cell;
-		node_list->node_count++;
+		node_info_list_append(node_list, cell);
 	}
 
 	return;
@@ -3618,6 +4593,104 @@ witness_copy_node_records(PGconn *primary_conn, PGconn *witness_conn)
 }
 
 
+/*
+ * Compute a digest of the "repmgr.nodes" table contents, for cheap
+ * comparison of the node records on two servers.
+ */
+static bool
+_get_node_records_digest(PGconn *conn, char *digest)
+{
+	PGresult   *res = NULL;
+	bool		success = true;
+
+	const char *sqlquery =
+		"SELECT COALESCE(md5(string_agg(n::text, ',' ORDER BY n.node_id)), '') "
+		"  FROM repmgr.nodes n";
+
+	res = PQexec(conn, sqlquery);
+
+	if (PQresultStatus(res) != PGRES_TUPLES_OK)
+	{
+		log_db_error(conn, sqlquery, _("_get_node_records_digest(): unable to execute query"));
+		success = false;
+	}
+	else
+	{
+		snprintf(digest, MAXLEN, "%s", PQgetvalue(res, 0, 0));
+	}
+
+	PQclear(res);
+
+	return success;
+}
+
+
+/*
+ * Synchronise node records from primary to witness, skipping the copy
+ * entirely if the node records are already identical. Called by repmgrd
+ * at each "witness_sync_interval"; usually nothing has changed, in which
+ * case this generates no write churn on the witness.
+ *
+ * "last_synced_digest" (buffer of at least MAXLEN bytes), if provided,
+ * caches the digest of the most recently synchronised node records; while
+ * the primary's digest matches it, the sync can be skipped with a single
+ * scalar query against the primary and no processing at all on the
+ * witness. Pass an empty string initially (or to invalidate the cache);
+ * callers without a suitable cache location can pass NULL, in which case
+ * the digests on both servers are compared directly.
+ */
+bool
+witness_sync_node_records(PGconn *primary_conn, PGconn *witness_conn, char *last_synced_digest)
+{
+	char		primary_digest[MAXLEN] = "";
+	bool		synced = true;
+
+	if (_get_node_records_digest(primary_conn, primary_digest) == true)
+	{
+		if (last_synced_digest != NULL && last_synced_digest[0] != '\0')
+		{
+			if (strncmp(primary_digest, last_synced_digest, MAXLEN) == 0)
+			{
+				log_verbose(LOG_DEBUG, "witness_sync_node_records(): node records unchanged, skipping sync");
+				return true;
+			}
+		}
+		else
+		{
+			char		witness_digest[MAXLEN] = "";
+
+			if (_get_node_records_digest(witness_conn, witness_digest) == true
+				&& strncmp(primary_digest, witness_digest, MAXLEN) == 0)
+			{
+				log_verbose(LOG_DEBUG, "witness_sync_node_records(): node records unchanged, skipping sync");
+
+				if (last_synced_digest != NULL)
+					snprintf(last_synced_digest, MAXLEN, "%s", primary_digest);
+
+				return true;
+			}
+		}
+	}
+
+	synced = witness_copy_node_records(primary_conn, witness_conn);
+
+	/*
+	 * Cache the digest retrieved before the copy; should the primary's node
+	 * records have changed in the meantime, the stale cache entry will simply
+	 * trigger a further sync at the next interval.
+	 */
+	if (last_synced_digest != NULL)
+	{
+		if (synced == true)
+			snprintf(last_synced_digest, MAXLEN, "%s", primary_digest);
+		else
+			last_synced_digest[0] = '\0';
+	}
+
+	return synced;
+}
+
+
 bool
 delete_node_record(PGconn *conn, int node)
 {
@@ -3704,6 +4777,49 @@ update_node_record_slot_name(PGconn *primary_conn, int node_id, char *slot_name)
 
 
 
+/*
+ * Append a cell to a node list, maintaining the hash index keyed on
+ * node_id which backs node_info_list_find().
+ */
+void
+node_info_list_append(NodeInfoList *nodes, NodeInfoListCell *cell)
+{
+	unsigned int bucket = (unsigned int) cell->node_info->node_id % NODE_INFO_HASH_BUCKETS;
+
+	if (nodes->tail)
+		nodes->tail->next = cell;
+	else
+		nodes->head = cell;
+
+	nodes->tail = cell;
+	nodes->node_count++;
+
+	cell->hash_next = nodes->hash_buckets[bucket];
+	nodes->hash_buckets[bucket] = cell;
+}
+
+
+/*
+ * Return the list entry for the given node_id, or NULL if the node is
+ * not in the list; O(1) via the list's hash index.
+ */
+t_node_info *
+node_info_list_find(NodeInfoList *nodes, int node_id)
+{
+	NodeInfoListCell *cell = NULL;
+
+	for (cell = nodes->hash_buckets[(unsigned int) node_id % NODE_INFO_HASH_BUCKETS];
+		 cell != NULL;
+		 cell = cell->hash_next)
+	{
+		if (cell->node_info->node_id == node_id)
+			return cell->node_info;
+	}
+
+	return NULL;
+}
+
+
 void
 clear_node_info_list(NodeInfoList *nodes)
 {
@@ -3734,14 +4850,21 @@ clear_node_info_list(NodeInfoList *nodes)
 		if (cell->node_info->replication_info != NULL)
 			pfree(cell->node_info->replication_info);
 
-		pfree(cell->node_info);
-		pfree(cell);
+		/* arena-backed cells are freed wholesale when the arena is reset */
+		if (nodes->arena == NULL)
+		{
+			pfree(cell->node_info);
+			pfree(cell);
+		}
+
 		cell = next_cell;
 	}
 
 	nodes->head = NULL;
 	nodes->tail = NULL;
 	nodes->node_count = 0;
+
+	memset(nodes->hash_buckets, 0, sizeof(nodes->hash_buckets));
 }
 
 
@@ -4116,7 +5239,6 @@ _create_event(PGconn *conn, t_configuration_options *options, int node_id, char
 		const char *src_ptr = NULL;
 		char	   *dst_ptr = NULL;
 		char	   *end_ptr = NULL;
-		int			r = 0;
 
 		log_verbose(LOG_DEBUG, "_create_event(): command is '%s'", options->event_notification_command);
 		/*
@@ -4264,8 +5386,8 @@ _create_event(PGconn *conn, t_configuration_options *options, int node_id, char
 				 event);
 
 		log_detail(_("command is:\n  %s"), parsed_command);
-		r = system(parsed_command);
-		if (r != 0)
+
+		if (execute_notification_command(parsed_command, event) == false)
 		{
 			log_warning(_("unable to execute event notification command"));
 			log_detail(_("parsed event notification command was:\n  %s"), parsed_command);
@@ -4277,8 +5399,19 @@ _create_event(PGconn *conn, t_configuration_options *options, int node_id, char
 }
 
 
+/*
+ * Retrieve one batch of event records, keyset-paginated on
+ * (event_timestamp, node_id); the caller passes the cursor position of the
+ * last record in the previous batch (or an empty "cursor_timestamp" to
+ * retrieve the first batch) and streams batches until fewer than
+ * "batch_size" records are returned.
+ *
+ * The raw event timestamp is returned as an additional trailing column for
+ * use as the cursor position, as the displayed timestamp is truncated to
+ * seconds.
+ */
 PGresult *
-get_event_records(PGconn *conn, int node_id, const char *node_name, const char *event, bool all, int limit)
+get_event_records(PGconn *conn, int node_id, const char *node_name, const char *event, const char *since, const char *until, const char *cursor_timestamp, int cursor_node_id, int batch_size)
 {
 	PGresult   *res;
 
@@ -4293,7 +5426,8 @@ get_event_records(PGconn *conn, int node_id, const char *node_name, const char *
 	appendPQExpBufferStr(&query,
 						 "   SELECT e.node_id, n.node_name, e.event, e.successful, "
 						 "          pg_catalog.to_char(e.event_timestamp, 'YYYY-MM-DD HH24:MI:SS') AS timestamp, "
-						 "          e.details "
+						 "          e.details, "
+						 "          e.event_timestamp AS event_timestamp_raw "
 						 "     FROM repmgr.events e "
 						 "LEFT JOIN repmgr.nodes n ON e.node_id = n.node_id ");
 
@@ -4338,19 +5472,67 @@ get_event_records(PGconn *conn, int node_id, const char *node_name, const char *
 		}
 	}
 
+	if (since != NULL && since[0] != '\0')
+	{
+		char	   *escaped = escape_string(conn, since);
+
+		if (escaped == NULL)
+		{
+			log_error(_("unable to escape value provided for --since"));
+			log_detail(_("timestamp is: \"%s\""), since);
+		}
+		else
+		{
+			append_where_clause(&where_clause,
+								"e.event_timestamp >= '%s'",
+								escaped);
+			pfree(escaped);
+		}
+	}
+
+	if (until != NULL && until[0] != '\0')
+	{
+		char	   *escaped = escape_string(conn, until);
+
+		if (escaped == NULL)
+		{
+			log_error(_("unable to escape value provided for --until"));
+			log_detail(_("timestamp is: \"%s\""), until);
+		}
+		else
+		{
+			append_where_clause(&where_clause,
+								"e.event_timestamp <= '%s'",
+								escaped);
+			pfree(escaped);
+		}
+	}
+
+	/*
+	 * Resume after the last record of the previous batch; the row comparison
+	 * matches the descending sort order below.
+	 */
+	if (cursor_timestamp != NULL && cursor_timestamp[0] != '\0')
+	{
+		append_where_clause(&where_clause,
+							"(e.event_timestamp, e.node_id) < ('%s', %i)",
+							cursor_timestamp,
+							cursor_node_id);
+	}
+
 	appendPQExpBuffer(&query, "\n%s\n",
 					  where_clause.data);
 
 	appendPQExpBufferStr(&query,
-						 " ORDER BY e.event_timestamp DESC");
+						 " ORDER BY e.event_timestamp DESC, e.node_id DESC");
 
-	if (all == false && limit > 0)
+	if (batch_size > 0)
 	{
 		appendPQExpBuffer(&query, " LIMIT %i",
-						  limit);
+						  batch_size);
 	}
 
-	log_debug("do_cluster_event():\n%s", query.data);
+	log_debug("get_event_records():\n%s", query.data);
 	res = PQexec(conn, query.data);
 
 	termPQExpBuffer(&query);
@@ -5062,6 +6244,106 @@ add_monitoring_record(PGconn *primary_conn,
 }
 
 
+/*
+ * Write a batch of spooled monitoring samples as a single multi-row
+ * INSERT. Returns false if the query could not be dispatched, in which
+ * case the caller should retain the samples and retry later.
+ */
+bool
+add_monitoring_records(PGconn *primary_conn,
+					   PGconn *local_conn,
+					   t_monitoring_record *records,
+					   int record_count)
+{
+	PQExpBufferData query;
+	int			i;
+	bool		success = true;
+
+	if (record_count == 0)
+		return true;
+
+	initPQExpBuffer(&query);
+
+	appendPQExpBufferStr(&query,
+						 "INSERT INTO repmgr.monitoring_history "
+						 "           (primary_node_id, "
+						 "            standby_node_id, "
+						 "            last_monitor_time, "
+						 "            last_apply_time, "
+						 "            last_wal_primary_location, "
+						 "            last_wal_standby_location, "
+						 "            replication_lag, "
+						 "            apply_lag ) "
+						 "     VALUES ");
+
+	for (i = 0; i < record_count; i++)
+	{
+		appendPQExpBuffer(&query,
+						  "%s(%i, "
+						  " %i, "
+						  " '%s'::TIMESTAMP WITH TIME ZONE, "
+						  " '%s'::TIMESTAMP WITH TIME ZONE, "
+						  " '%X/%X', "
+						  " '%X/%X', "
+						  " %llu, "
+						  " %llu)",
+						  i == 0 ? "" : ", ",
+						  records[i].primary_node_id,
+						  records[i].standby_node_id,
+						  records[i].monitor_standby_timestamp,
+						  records[i].last_xact_replay_timestamp,
+						  format_lsn(records[i].primary_last_wal_location),
+						  format_lsn(records[i].last_wal_receive_lsn),
+						  records[i].replication_lag_bytes,
+						  records[i].apply_lag_bytes);
+	}
+
+	log_verbose(LOG_DEBUG, "add_monitoring_records(): writing %i record(s)", record_count);
+
+	if (PQsendQuery(primary_conn, query.data) == 0)
+	{
+		log_warning(_("query could not be sent to primary:\n  %s"),
+					PQerrorMessage(primary_conn));
+		success = false;
+	}
+	else
+	{
+		PGresult   *res = PQexec(local_conn, "SELECT repmgr.standby_set_last_updated()");
+
+		/* not critical if the above query fails */
+		if (PQresultStatus(res) != PGRES_TUPLES_OK)
+			log_warning(_("add_monitoring_records(): unable to set last_updated:\n  %s"),
+						PQerrorMessage(local_conn));
+
+		PQclear(res);
+
+		/*
+		 * Collect the INSERT's result; the last_updated query above ran on
+		 * the local connection while the INSERT was in flight, so the
+		 * batch still costs only one primary round trip. A failed INSERT
+		 * must be reported to the caller so the spooled samples are
+		 * retained, and the result must be consumed in any case so the
+		 * connection is not left with a command in progress.
+		 */
+		while ((res = PQgetResult(primary_conn)) != NULL)
+		{
+			if (PQresultStatus(res) != PGRES_COMMAND_OK)
+			{
+				log_warning(_("add_monitoring_records(): unable to write monitoring records:\n  %s"),
+							PQerrorMessage(primary_conn));
+				success = false;
+			}
+
+			PQclear(res);
+		}
+	}
+
+	termPQExpBuffer(&query);
+
+	return success;
+}
+
+
 int
 get_number_of_monitoring_records_to_delete(PGconn *primary_conn, int keep_history, int node_id)
 {
@@ -5147,6 +6429,61 @@ delete_monitoring_records(PGconn *primary_conn, int keep_history, int node_id)
 	return success;
 }
 
+
+/*
+ * Delete one bounded batch of expired monitoring records; as the table has
+ * no primary key, the batch is selected by ctid. Returns the number of
+ * records deleted (possibly 0), or -1 on error; the caller loops until
+ * fewer than "batch_size" records are deleted, pausing between batches to
+ * avoid generating one long burst of I/O and WAL.
+ */
+int
+delete_monitoring_records_batch(PGconn *primary_conn, int keep_history, int node_id, int batch_size)
+{
+	PQExpBufferData query;
+	int				deleted = -1;
+	PGresult	   *res = NULL;
+
+	initPQExpBuffer(&query);
+
+	appendPQExpBuffer(&query,
+					  "DELETE FROM repmgr.monitoring_history "
+					  " WHERE ctid IN ( "
+					  "          SELECT ctid "
+					  "            FROM repmgr.monitoring_history "
+					  "           WHERE pg_catalog.age(pg_catalog.now(), last_monitor_time) >= '%d days'::INTERVAL ",
+					  keep_history);
+
+	if (node_id != UNKNOWN_NODE_ID)
+	{
+		appendPQExpBuffer(&query,
+						  "  AND standby_node_id = %i", node_id);
+	}
+
+	appendPQExpBuffer(&query,
+					  "           LIMIT %i)",
+					  batch_size);
+
+	log_verbose(LOG_DEBUG, "delete_monitoring_records_batch():\n  %s", query.data);
+
+	res = PQexec(primary_conn, query.data);
+
+	if (PQresultStatus(res) != PGRES_COMMAND_OK)
+	{
+		log_db_error(primary_conn, query.data,
+					 _("delete_monitoring_records_batch(): unable to delete monitoring records"));
+	}
+	else
+	{
+		deleted = atoi(PQcmdTuples(res));
+	}
+
+	termPQExpBuffer(&query);
+	PQclear(res);
+
+	return deleted;
+}
+
 /*
  * node voting functions
  *
@@ -5282,6 +6619,62 @@ notify_follow_primary(PGconn *conn, int primary_node_id)
 }
 
 
+/*
+ * Dispatch repmgr.notify_follow_primary() without waiting for the result;
+ * collect the outcome later with notify_follow_primary_collect(). This
+ * enables a set of follower nodes to be notified concurrently rather than
+ * one-by-one.
+ */
+bool
+notify_follow_primary_send(PGconn *conn, int primary_node_id)
+{
+	PQExpBufferData query;
+	bool		success = true;
+
+	initPQExpBuffer(&query);
+
+	appendPQExpBuffer(&query,
+					  "SELECT repmgr.notify_follow_primary(%i)",
+					  primary_node_id);
+
+	log_verbose(LOG_DEBUG, "notify_follow_primary_send():\n  %s", query.data);
+
+	if (PQsendQuery(conn, query.data) == 0)
+	{
+		log_db_error(conn, query.data, _("unable to dispatch repmgr.notify_follow_primary()"));
+		success = false;
+	}
+
+	termPQExpBuffer(&query);
+
+	return success;
+}
+
+
+/*
+ * Retrieve the result of a previous notify_follow_primary_send() call.
+ */
+bool
+notify_follow_primary_collect(PGconn *conn)
+{
+	PGresult   *res = NULL;
+	bool		success = true;
+
+	while ((res = PQgetResult(conn)) != NULL)
+	{
+		if (PQresultStatus(res) != PGRES_TUPLES_OK)
+		{
+			log_db_error(conn, NULL, _("unable to execute repmgr.notify_follow_primary()"));
+			success = false;
+		}
+
+		PQclear(res);
+	}
+
+	return success;
+}
+
+
 bool
 get_new_primary(PGconn *conn, int *primary_node_id)
 {
@@ -5522,15 +6915,10 @@ init_replication_info(ReplInfo *replication_info)
 }
 
 
-bool
-get_replication_info(PGconn *conn, t_server_type node_type, ReplInfo *replication_info)
+static void
+_build_replication_info_query(PQExpBufferData *query, PGconn *conn, t_server_type node_type)
 {
-	PQExpBufferData query;
-	PGresult   *res = NULL;
-	bool		success = true;
-
-	initPQExpBuffer(&query);
-	appendPQExpBufferStr(&query,
+	appendPQExpBufferStr(query,
 						 " SELECT ts, "
 						 "        in_recovery, "
 						 "        last_wal_receive_lsn, "
@@ -5557,7 +6945,7 @@ get_replication_info(PGconn *conn, t_server_type node_type, ReplInfo *replicatio
 
 	if (PQserverVersion(conn) >= 100000)
 	{
-		appendPQExpBufferStr(&query,
+		appendPQExpBufferStr(query,
 							 "        COALESCE(pg_catalog.pg_last_wal_receive_lsn(), '0/0'::PG_LSN) AS last_wal_receive_lsn, "
 							 "        COALESCE(pg_catalog.pg_last_wal_replay_lsn(),  '0/0'::PG_LSN) AS last_wal_replay_lsn, "
 							 "        CASE WHEN pg_catalog.pg_is_in_recovery() IS FALSE "
@@ -5567,7 +6955,7 @@ get_replication_info(PGconn *conn, t_server_type node_type, ReplInfo *replicatio
 	}
 	else
 	{
-		appendPQExpBufferStr(&query,
+		appendPQExpBufferStr(query,
 							 "        COALESCE(pg_catalog.pg_last_xlog_receive_location(), '0/0'::PG_LSN) AS last_wal_receive_lsn, "
 							 "        COALESCE(pg_catalog.pg_last_xlog_replay_location(),  '0/0'::PG_LSN) AS last_wal_replay_lsn, "
 							 "        CASE WHEN pg_catalog.pg_is_in_recovery() IS FALSE "
@@ -5579,57 +6967,173 @@ get_replication_info(PGconn *conn, t_server_type node_type, ReplInfo *replicatio
 	/* Add information about upstream node from shared memory */
 	if (node_type == WITNESS)
 	{
-		appendPQExpBufferStr(&query,
+		appendPQExpBufferStr(query,
 							 "        repmgr.get_upstream_last_seen() AS upstream_last_seen, "
 							 "        repmgr.get_upstream_node_id() AS upstream_node_id ");
 	}
 	else
 	{
-		appendPQExpBufferStr(&query,
+		appendPQExpBufferStr(query,
 							 "        CASE WHEN pg_catalog.pg_is_in_recovery() IS FALSE "
 							 "          THEN -1 "
 							 "          ELSE repmgr.get_upstream_last_seen() "
 							 "        END AS upstream_last_seen, ");
-		appendPQExpBufferStr(&query,
+		appendPQExpBufferStr(query,
 							 "        CASE WHEN pg_catalog.pg_is_in_recovery() IS FALSE "
 							 "          THEN -1 "
 							 "          ELSE repmgr.get_upstream_node_id() "
 							 "        END AS upstream_node_id ");
 	}
 
-	appendPQExpBufferStr(&query,
+	appendPQExpBufferStr(query,
 						 "          ) q ");
 
+}
+
+
+static bool
+_parse_replication_info(PGresult *res, ReplInfo *replication_info)
+{
+	if (PQresultStatus(res) != PGRES_TUPLES_OK || !PQntuples(res))
+		return false;
+
+	snprintf(replication_info->current_timestamp,
+			 sizeof(replication_info->current_timestamp),
+			 "%s", PQgetvalue(res, 0, 0));
+	replication_info->in_recovery = atobool(PQgetvalue(res, 0, 1));
+	replication_info->last_wal_receive_lsn = parse_lsn(PQgetvalue(res, 0, 2));
+	replication_info->last_wal_replay_lsn = parse_lsn(PQgetvalue(res, 0, 3));
+	snprintf(replication_info->last_xact_replay_timestamp,
+			 sizeof(replication_info->last_xact_replay_timestamp),
+			 "%s", PQgetvalue(res, 0, 4));
+	replication_info->replication_lag_time = atoi(PQgetvalue(res, 0, 5));
+	replication_info->receiving_streamed_wal = atobool(PQgetvalue(res, 0, 6));
+	replication_info->wal_replay_paused = atobool(PQgetvalue(res, 0, 7));
+	replication_info->upstream_last_seen = atoi(PQgetvalue(res, 0, 8));
+	replication_info->upstream_node_id = atoi(PQgetvalue(res, 0, 9));
+
+	return true;
+}
+
+
+bool
+get_replication_info(PGconn *conn, t_server_type node_type, ReplInfo *replication_info)
+{
+	PQExpBufferData query;
+	PGresult   *res = NULL;
+	bool		success = true;
+
+	initPQExpBuffer(&query);
+	_build_replication_info_query(&query, conn, node_type);
+
 	log_verbose(LOG_DEBUG, "get_replication_info():\n%s", query.data);
 
 	res = PQexec(conn, query.data);
 
-	if (PQresultStatus(res) != PGRES_TUPLES_OK || !PQntuples(res))
+	if (_parse_replication_info(res, replication_info) == false)
 	{
 		log_db_error(conn, query.data, _("get_replication_info(): unable to execute query"));
 
 		success = false;
 	}
+
+	termPQExpBuffer(&query);
+	PQclear(res);
+
+	return success;
+}
+
+
+/*
+ * Fetch the local-node status set required by each repmgrd standby
+ * monitoring tick - replication status, the node ID stored in shared
+ * memory, and the local node record - as a single query batch, which
+ * with libpq 14 and later is executed in one network round trip (see
+ * execute_query_batch()). Previously each of these was a separate
+ * synchronous query, each paying a full round trip per monitoring
+ * interval.
+ *
+ * Returns false if the replication status could not be retrieved;
+ * "stored_local_node_id" and "record_status" are always set.
+ */
+bool
+get_standby_monitoring_snapshot(PGconn *conn, int node_id,
+								ReplInfo *replication_info,
+								int *stored_local_node_id,
+								t_node_info *node_info,
+								RecordStatus *record_status)
+{
+	PQExpBufferData replication_info_query;
+	PQExpBufferData node_record_query;
+	const char *queries[3];
+	PGresult   *results[3];
+	bool		success = true;
+	int			i;
+
+	initPQExpBuffer(&replication_info_query);
+	_build_replication_info_query(&replication_info_query, conn, STANDBY);
+
+	initPQExpBuffer(&node_record_query);
+	appendPQExpBuffer(&node_record_query,
+					  "SELECT " REPMGR_NODES_COLUMNS
+					  "  FROM repmgr.nodes n "
+					  " WHERE n.node_id = %i",
+					  node_id);
+
+	queries[0] = replication_info_query.data;
+	queries[1] = "SELECT repmgr.get_local_node_id()";
+	queries[2] = node_record_query.data;
+
+	(void) execute_query_batch(conn, 3, queries, results);
+
+	/* replication status */
+	if (results[0] == NULL || _parse_replication_info(results[0], replication_info) == false)
+	{
+		log_db_error(conn, replication_info_query.data,
+					 _("get_standby_monitoring_snapshot(): unable to retrieve replication status"));
+		success = false;
+	}
+
+	/* node ID stored in shared memory */
+	*stored_local_node_id = UNKNOWN_NODE_ID;
+
+	if (results[1] != NULL && PQresultStatus(results[1]) == PGRES_TUPLES_OK)
+	{
+		if (!PQgetisnull(results[1], 0, 0))
+			*stored_local_node_id = atoi(PQgetvalue(results[1], 0, 0));
+	}
 	else
 	{
-		snprintf(replication_info->current_timestamp,
-				 sizeof(replication_info->current_timestamp),
-				 "%s", PQgetvalue(res, 0, 0));
-		replication_info->in_recovery = atobool(PQgetvalue(res, 0, 1));
-		replication_info->last_wal_receive_lsn = parse_lsn(PQgetvalue(res, 0, 2));
-		replication_info->last_wal_replay_lsn = parse_lsn(PQgetvalue(res, 0, 3));
-		snprintf(replication_info->last_xact_replay_timestamp,
-				 sizeof(replication_info->last_xact_replay_timestamp),
-				 "%s", PQgetvalue(res, 0, 4));
-		replication_info->replication_lag_time = atoi(PQgetvalue(res, 0, 5));
-		replication_info->receiving_streamed_wal = atobool(PQgetvalue(res, 0, 6));
-		replication_info->wal_replay_paused = atobool(PQgetvalue(res, 0, 7));
-		replication_info->upstream_last_seen = atoi(PQgetvalue(res, 0, 8));
-		replication_info->upstream_node_id = atoi(PQgetvalue(res, 0, 9));
+		log_db_error(conn, queries[1],
+					 _("get_standby_monitoring_snapshot(): unable to retrieve stored local node ID"));
 	}
 
-	termPQExpBuffer(&query);
-	PQclear(res);
+	/* local node record */
+	if (results[2] == NULL || PQresultStatus(results[2]) != PGRES_TUPLES_OK)
+	{
+		log_db_error(conn, node_record_query.data,
+					 _("get_standby_monitoring_snapshot(): unable to retrieve node record"));
+		*record_status = RECORD_ERROR;
+	}
+	else if (PQntuples(results[2]) == 0)
+	{
+		log_verbose(LOG_DEBUG, "get_standby_monitoring_snapshot(): no record found for node %i", node_id);
+		*record_status = RECORD_NOT_FOUND;
+	}
+	else
+	{
+		_populate_node_record(results[2], node_info, 0, false);
+		*record_status = RECORD_FOUND;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		if (results[i] != NULL)
+			PQclear(results[i]);
+	}
+
+	termPQExpBuffer(&replication_info_query);
+	termPQExpBuffer(&node_record_query);
 
 	return success;
 }
@@ -5686,6 +7190,129 @@ get_replication_lag_seconds(PGconn *conn)
 }
 
 
+/*
+ * Prefetch, in a single batched round trip (see execute_query_batch()),
+ * the results of the independent queries executed by the general overview
+ * mode of "repmgr node check": replication lag, monitoring role membership
+ * and the "data_directory" setting.
+ *
+ * If the batch could not be executed, "prefetched" remains false and the
+ * individual checks will fall back to executing their queries one-by-one.
+ */
+bool
+get_node_check_snapshot(PGconn *conn, t_node_check_snapshot *snapshot)
+{
+	PQExpBufferData lag_query;
+	PQExpBufferData role_query;
+	const char *queries[3];
+	PGresult   *results[3] = {NULL, NULL, NULL};
+	int			query_count = 0;
+	int			lag_ix = -1;
+	int			role_ix = -1;
+	int			setting_ix = -1;
+	bool		success = false;
+	int			i;
+
+	snapshot->prefetched = false;
+	snapshot->replication_lag_seconds = UNKNOWN_REPLICATION_LAG;
+	snapshot->has_read_all_settings_role = false;
+	memset(snapshot->data_directory, 0, sizeof(snapshot->data_directory));
+
+	initPQExpBuffer(&lag_query);
+	initPQExpBuffer(&role_query);
+
+	/* same query as executed by get_replication_lag_seconds() */
+	if (PQserverVersion(conn) >= 100000)
+	{
+		appendPQExpBufferStr(&lag_query,
+							 " SELECT CASE WHEN (pg_catalog.pg_last_wal_receive_lsn() = pg_catalog.pg_last_wal_replay_lsn()) ");
+	}
+	else
+	{
+		appendPQExpBufferStr(&lag_query,
+							 " SELECT CASE WHEN (pg_catalog.pg_last_xlog_receive_location() = pg_catalog.pg_last_xlog_replay_location()) ");
+	}
+
+	appendPQExpBufferStr(&lag_query,
+						 "          THEN 0 "
+						 "        ELSE EXTRACT(epoch FROM (pg_catalog.clock_timestamp() - pg_catalog.pg_last_xact_replay_timestamp()))::INT "
+						 "          END "
+						 "        AS lag_seconds");
+
+	lag_ix = query_count;
+	queries[query_count++] = lag_query.data;
+
+	/*
+	 * Role membership: superusers can read anything (no query needed), and
+	 * "pg_monitor" and its constituent "subroles" were only introduced in
+	 * PostgreSQL 10.
+	 */
+	if (is_superuser_connection(conn, NULL) == true)
+	{
+		snapshot->has_read_all_settings_role = true;
+	}
+	else if (PQserverVersion(conn) >= 100000)
+	{
+		appendPQExpBufferStr(&role_query,
+							 "  SELECT CASE "
+							 "           WHEN pg_catalog.pg_has_role('pg_monitor','MEMBER') "
+							 "             THEN TRUE "
+							 "           WHEN pg_catalog.pg_has_role('pg_read_all_settings','MEMBER') "
+							 "             THEN TRUE "
+							 "           ELSE FALSE "
+							 "         END AS has_pg_monitor");
+
+		role_ix = query_count;
+		queries[query_count++] = role_query.data;
+	}
+
+	setting_ix = query_count;
+	queries[query_count++] = "SELECT name, setting "
+		"  FROM pg_catalog.pg_settings WHERE name = 'data_directory'";
+
+	success = execute_query_batch(conn, query_count, queries, results);
+
+	if (success == true)
+	{
+		snapshot->prefetched = true;
+
+		if (results[lag_ix] != NULL
+			&& PQresultStatus(results[lag_ix]) == PGRES_TUPLES_OK
+			&& PQntuples(results[lag_ix]) == 1)
+		{
+			snapshot->replication_lag_seconds = atoi(PQgetvalue(results[lag_ix], 0, 0));
+		}
+
+		if (role_ix >= 0
+			&& results[role_ix] != NULL
+			&& PQresultStatus(results[role_ix]) == PGRES_TUPLES_OK
+			&& PQntuples(results[role_ix]) == 1)
+		{
+			snapshot->has_read_all_settings_role = atobool(PQgetvalue(results[role_ix], 0, 0));
+		}
+
+		if (results[setting_ix] != NULL
+			&& PQresultStatus(results[setting_ix]) == PGRES_TUPLES_OK
+			&& PQntuples(results[setting_ix]) == 1)
+		{
+			snprintf(snapshot->data_directory,
+					 sizeof(snapshot->data_directory),
+					 "%s", PQgetvalue(results[setting_ix], 0, 1));
+		}
+	}
+
+	for (i = 0; i < query_count; i++)
+	{
+		if (results[i] != NULL)
+			PQclear(results[i]);
+	}
+
+	termPQExpBuffer(&lag_query);
+	termPQExpBuffer(&role_query);
+
+	return success;
+}
+
 
 TimeLineID
 get_node_timeline(PGconn *conn, char *timeline_id_str)
@@ -182,6 +182,22 @@ typedef struct
 	int			upstream_node_id;
 } ReplInfo;
 
+/*
+ * One monitoring_history sample, as spooled locally by repmgrd and
+ * written in batches by add_monitoring_records().
+ */
+typedef struct
+{
+	int			primary_node_id;
+	int			standby_node_id;
+	char		monitor_standby_timestamp[MAXLEN];
+	char		last_xact_replay_timestamp[MAXLEN];
+	XLogRecPtr	primary_last_wal_location;
+	XLogRecPtr	last_wal_receive_lsn;
+	long long unsigned int replication_lag_bytes;
+	long long unsigned int apply_lag_bytes;
+} t_monitoring_record;
+
 /*
  * Struct to store node information.
  *
@@ -255,9 +271,14 @@ typedef struct s_node_info
 
 
 /* structs to store a list of repmgr node records */
+
+/* number of buckets in the node_id hash index maintained for each list */
+#define NODE_INFO_HASH_BUCKETS 64
+
 typedef struct NodeInfoListCell
 {
 	struct NodeInfoListCell *next;
+	struct NodeInfoListCell *hash_next;	/* next cell in the same hash bucket */
 	t_node_info *node_info;
 } NodeInfoListCell;
 
@@ -266,12 +287,26 @@ typedef struct NodeInfoList
 	NodeInfoListCell *head;
 	NodeInfoListCell *tail;
 	int			node_count;
+
+	/*
+	 * hash index keyed on node_id, maintained by node_info_list_append()
+	 * and queried with node_info_list_find()
+	 */
+	NodeInfoListCell *hash_buckets[NODE_INFO_HASH_BUCKETS];
+
+	/*
+	 * if set, cells and node records are allocated from this arena and
+	 * freed by resetting it, rather than individually
+	 */
+	MemoryArena *arena;
 } NodeInfoList;
 
 #define T_NODE_INFO_LIST_INITIALIZER { \
 	NULL, \
 	NULL, \
-	0 \
+	0, \
+	{NULL}, \
+	NULL \
 }
 
 typedef struct s_event_info
@@ -360,6 +395,26 @@ typedef struct
 }
 
 
+/*
+ * Struct to store the prefetched results of the queries executed by the
+ * "repmgr node check" overview mode (see get_node_check_snapshot())
+ */
+typedef struct
+{
+	bool		prefetched;
+	int			replication_lag_seconds;
+	bool		has_read_all_settings_role;
+	char		data_directory[MAXPGPATH];
+} t_node_check_snapshot;
+
+#define T_NODE_CHECK_SNAPSHOT_INITIALIZER { \
+	false, \
+	UNKNOWN_REPLICATION_LAG, \
+	false, \
+	"" \
+}
+
+
 typedef struct RepmgrdInfo {
 	int node_id;
 	int pid;
@@ -391,6 +446,7 @@ bool		atobool(const char *value);
 PGconn	   *establish_db_connection(const char *conninfo,
 						const bool exit_on_error);
 PGconn	   *establish_db_connection_quiet(const char *conninfo);
+void		establish_node_connections_parallel(NodeInfoList *nodes);
 PGconn	   *establish_db_connection_by_params(t_conninfo_param_list *param_list,
 								  const bool exit_on_error);
 PGconn	   *establish_db_connection_with_replacement_param(const char *conninfo,
@@ -430,6 +486,9 @@ bool		begin_transaction(PGconn *conn);
 bool		commit_transaction(PGconn *conn);
 bool		rollback_transaction(PGconn *conn);
 
+/* query batching functions */
+bool		execute_query_batch(PGconn *conn, int query_count, const char *const *queries, PGresult **results);
+
 /* GUC manipulation functions */
 bool		set_config(PGconn *conn, const char *config_param, const char *config_value);
 bool		set_config_bool(PGconn *conn, const char *config_param, bool state);
@@ -446,10 +505,10 @@ int			get_server_version(PGconn *conn, char *server_version_buf);
 
 RecoveryType get_recovery_type(PGconn *conn);
 int			get_primary_node_id(PGconn *conn);
-int			get_ready_archive_files(PGconn *conn, const char *data_directory);
+int			get_ready_archive_files(PGconn *conn, const char *data_directory, int max_files, int cache_ttl);
 bool		identify_system(PGconn *repl_conn, t_system_identification *identification);
 uint64		system_identifier(PGconn *conn);
-TimeLineHistoryEntry *get_timeline_history(PGconn *repl_conn, TimeLineID tli);
+TimeLineHistoryEntry *get_timeline_history(PGconn *repl_conn, TimeLineID tli, const char *local_data_directory);
 
 /* user/role information functions */
 bool		can_execute_pg_promote(PGconn *conn);
@@ -464,6 +523,10 @@ bool		repmgrd_check_local_node_id(PGconn *conn);
 BackupState	server_in_exclusive_backup_mode(PGconn *conn);
 void		repmgrd_set_pid(PGconn *conn, pid_t repmgrd_pid, const char *pidfile);
 pid_t		repmgrd_get_pid(PGconn *conn);
+void		repmgrd_set_timings(PGconn *conn, const char *timings);
+bool		repmgrd_get_timings(PGconn *conn, PQExpBufferData *timings);
+void		repmgrd_set_lag_stats(PGconn *conn, const char *lag_stats);
+bool		repmgrd_get_lag_stats(PGconn *conn, PQExpBufferData *lag_stats);
 bool		repmgrd_is_running(PGconn *conn);
 bool		repmgrd_is_paused(PGconn *conn);
 bool		repmgrd_pause(PGconn *conn, bool pause);
@@ -518,7 +581,10 @@ bool		update_node_record_conn_priority(PGconn *conn, t_configuration_options *op
 bool		update_node_record_slot_name(PGconn *primary_conn, int node_id, char *slot_name);
 
 bool		witness_copy_node_records(PGconn *primary_conn, PGconn *witness_conn);
+bool		witness_sync_node_records(PGconn *primary_conn, PGconn *witness_conn, char *last_synced_digest);
 
+void		node_info_list_append(NodeInfoList *nodes, NodeInfoListCell *cell);
+t_node_info *node_info_list_find(NodeInfoList *nodes, int node_id);
 void		clear_node_info_list(NodeInfoList *nodes);
 
 /* PostgreSQL configuration file location functions */
@@ -531,7 +597,7 @@ void		config_file_list_add(t_configfile_list *list, const char *file, const char
 bool		create_event_record(PGconn *conn, t_configuration_options *options, int node_id, char *event, bool successful, char *details);
 bool		create_event_notification(PGconn *conn, t_configuration_options *options, int node_id, char *event, bool successful, char *details);
 bool		create_event_notification_extended(PGconn *conn, t_configuration_options *options, int node_id, char *event, bool successful, char *details, t_event_info *event_info);
-PGresult   *get_event_records(PGconn *conn, int node_id, const char *node_name, const char *event, bool all, int limit);
+PGresult   *get_event_records(PGconn *conn, int node_id, const char *node_name, const char *event, const char *since, const char *until, const char *cursor_timestamp, int cursor_node_id, int batch_size);
 
 /* replication slot functions */
 void		create_slot_name(char *slot_name, int node_id);
@@ -573,8 +639,14 @@ add_monitoring_record(PGconn *primary_conn,
 					  long long unsigned int apply_lag_bytes
 );
 
+bool		add_monitoring_records(PGconn *primary_conn,
+								   PGconn *local_conn,
+								   t_monitoring_record *records,
+								   int record_count);
+
 int			get_number_of_monitoring_records_to_delete(PGconn *primary_conn, int keep_history, int node_id);
 bool		delete_monitoring_records(PGconn *primary_conn, int keep_history, int node_id);
+int			delete_monitoring_records_batch(PGconn *primary_conn, int keep_history, int node_id, int batch_size);
 
 
 
@@ -584,6 +656,8 @@ int			get_current_term(PGconn *conn);
 void		increment_current_term(PGconn *conn);
 bool		announce_candidature(PGconn *conn, t_node_info *this_node, t_node_info *other_node, int electoral_term);
 void		notify_follow_primary(PGconn *conn, int primary_node_id);
+bool		notify_follow_primary_send(PGconn *conn, int primary_node_id);
+bool		notify_follow_primary_collect(PGconn *conn);
 bool		get_new_primary(PGconn *conn, int *primary_node_id);
 void		reset_voting_status(PGconn *conn);
 
@@ -593,7 +667,9 @@ XLogRecPtr	get_node_current_lsn(PGconn *conn);
 XLogRecPtr	get_last_wal_receive_location(PGconn *conn);
 void		init_replication_info(ReplInfo *replication_info);
 bool		get_replication_info(PGconn *conn, t_server_type node_type, ReplInfo *replication_info);
+bool		get_standby_monitoring_snapshot(PGconn *conn, int node_id, ReplInfo *replication_info, int *stored_local_node_id, t_node_info *node_info, RecordStatus *record_status);
 int			get_replication_lag_seconds(PGconn *conn);
+bool		get_node_check_snapshot(PGconn *conn, t_node_check_snapshot *snapshot);
 TimeLineID	get_node_timeline(PGconn *conn, char *timeline_id_str);
 void		get_node_replication_stats(PGconn *conn, t_node_info *node_info);
 NodeAttached is_downstream_node_attached(PGconn *conn, char *node_name, char **node_state);
@@ -23,6 +23,7 @@
 #include <dirent.h>
 #include <signal.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <errno.h>
 #include <stdio.h>
 #include <string.h>
@@ -37,7 +38,11 @@
 #include "log.h"
 #include "controldata.h"
 
+/* maximum number of worker processes forked by rmdir_recursive() */
+#define RMDIR_RECURSIVE_MAX_WORKERS 8
+
 static int	unlink_dir_callback(const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf);
+static void _rmdir_queue_subtrees(const char *path, int depth, int queue_fd);
 
 /* PID can be negative if backend is standalone */
 typedef long pgpid_t;
@@ -335,7 +340,7 @@ create_pg_dir(const char *path, bool force)
 				if (force == true)
 				{
 					log_notice(_("-F/--force provided - deleting existing data directory \"%s\""), path);
-					nftw(path, unlink_dir_callback, 64, FTW_DEPTH | FTW_PHYS);
+					rmdir_recursive(path);
 
 					/* recreate the directory ourselves to ensure permissions are correct */
 					if (!create_dir(path))
@@ -355,7 +360,7 @@ create_pg_dir(const char *path, bool force)
 				if (force == true)
 				{
 					log_notice(_("deleting existing directory \"%s\""), path);
-					nftw(path, unlink_dir_callback, 64, FTW_DEPTH | FTW_PHYS);
+					rmdir_recursive(path);
 
 					/* recreate the directory ourselves to ensure permissions are correct */
 					if (!create_dir(path))
@@ -382,12 +387,135 @@ create_pg_dir(const char *path, bool force)
 
 
 
+/*
+ * Remove a directory and its contents.
+ *
+ * The bulk of the work is carried out by a pool of worker processes, each
+ * of which takes the next available subtree from a shared pipe and removes
+ * it; on large data directories (where the per-database directories under
+ * "base" hold most of the files) this allows removal to proceed at the
+ * device's metadata parallelism rather than serially.
+ *
+ * Subtrees are enumerated two levels below the target directory, so the
+ * per-database directories are individual work items. Anything not covered
+ * by a worker - loose files, emptied directories, symlinks (which, as
+ * before, are unlinked rather than followed) - is removed by a concluding
+ * serial pass, which also serves as the fallback if no workers could be
+ * started.
+ */
 int
 rmdir_recursive(const char *path)
 {
+	int			queue_fds[2];
+
+	if (pipe(queue_fds) == 0)
+	{
+		pid_t		worker_pids[RMDIR_RECURSIVE_MAX_WORKERS];
+		int			worker_count = 0;
+		int			i;
+
+		for (i = 0; i < RMDIR_RECURSIVE_MAX_WORKERS; i++)
+		{
+			pid_t		pid = fork();
+
+			if (pid == 0)
+			{
+				char		subtree[MAXPGPATH];
+				ssize_t		bytes;
+				int			rc = 0;
+
+				close(queue_fds[1]);
+
+				while ((bytes = read(queue_fds[0], subtree, MAXPGPATH)) == MAXPGPATH)
+				{
+					if (nftw(subtree, unlink_dir_callback, 64, FTW_DEPTH | FTW_PHYS) != 0)
+						rc = 1;
+				}
+
+				_exit(rc);
+			}
+
+			if (pid < 0)
+				break;
+
+			worker_pids[worker_count++] = pid;
+		}
+
+		close(queue_fds[0]);
+
+		/*
+		 * Feed the subtrees to the workers; they drain the pipe as we write,
+		 * so the queue is never limited by the pipe's capacity.
+		 */
+		if (worker_count > 0)
+			_rmdir_queue_subtrees(path, 2, queue_fds[1]);
+
+		close(queue_fds[1]);
+
+		for (i = 0; i < worker_count; i++)
+		{
+			int			status;
+
+			/*
+			 * A worker failure is not fatal here - whatever it could not
+			 * remove will be retried by the serial pass below.
+			 */
+			waitpid(worker_pids[i], &status, 0);
+		}
+	}
+
 	return nftw(path, unlink_dir_callback, 64, FTW_DEPTH | FTW_PHYS);
 }
 
+
+/*
+ * Recursively enumerate the subdirectories "depth" levels below "path" and
+ * write each one to the work queue as a fixed-size record; records no
+ * larger than PIPE_BUF are guaranteed to be written (and therefore read)
+ * atomically.
+ */
+static void
+_rmdir_queue_subtrees(const char *path, int depth, int queue_fd)
+{
+	DIR		   *dir;
+	struct dirent *entry;
+	char		subpath[MAXPGPATH];
+	struct stat st;
+
+	dir = opendir(path);
+
+	if (dir == NULL)
+		return;
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		if (strcmp(entry->d_name, ".") == 0 ||
+			strcmp(entry->d_name, "..") == 0)
+		{
+			continue;
+		}
+
+		snprintf(subpath, MAXPGPATH, "%s/%s", path, entry->d_name);
+
+		/* symlinks are left for the serial pass to unlink */
+		if (lstat(subpath, &st) != 0 || !S_ISDIR(st.st_mode))
+			continue;
+
+		if (depth > 1)
+		{
+			_rmdir_queue_subtrees(subpath, depth - 1, queue_fd);
+		}
+		else if (write(queue_fd, subpath, MAXPGPATH) != MAXPGPATH)
+		{
+			/* queue unwritable - remaining subtrees fall to the serial pass */
+			break;
+		}
+	}
+
+	closedir(dir);
+}
+
+
 static int
 unlink_dir_callback(const char *fpath, const struct stat *sb, int typeflag, struct FTW *ftwbuf)
 {
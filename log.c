@@ -26,6 +26,10 @@
 
 #include <stdarg.h>
 #include <time.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <limits.h>
+#include <sys/wait.h>
 
 #include "log.h"
 
@@ -40,6 +44,9 @@ static int	detect_log_facility(const char *facility);
 static void
 _stderr_log_with_level(const char *level_name, int level, const char *fmt, va_list ap)
 __attribute__((format(PG_PRINTF_ATTRIBUTE, 3, 0)));
+static void
+_async_log_write(const char *level_name, const char *fmt, va_list ap)
+__attribute__((format(PG_PRINTF_ATTRIBUTE, 2, 0)));
 
 int			log_type = REPMGR_STDERR;
 int			log_level = LOG_INFO;
@@ -53,6 +60,17 @@ int			terse_logging = false;
  */
 int			logger_output_mode = OM_DAEMON;
 
+/*
+ * Asynchronous logging state (see logger_enable_async()): when enabled,
+ * formatted log lines are pushed into a pipe drained by a separate writer
+ * process, so a log call on a critical path can never block on a stalled
+ * disk or pipe; the pipe's kernel buffer serves as the ring buffer.
+ */
+static bool async_logging = false;
+static int	async_log_fd = -1;
+static pid_t async_writer_pid = -1;
+static long async_dropped_messages = 0;
+
 extern void
 stderr_log_with_level(const char *level_name, int level, const char *fmt,...)
 {
@@ -76,6 +94,11 @@ _stderr_log_with_level(const char *level_name, int level, const char *fmt, va_li
 
 	if (log_level >= level)
 	{
+		if (async_logging == true)
+		{
+			_async_log_write(level_name, fmt, ap);
+			return;
+		}
 
 		/* Format log line prefix with timestamp if in daemon mode */
 		if (logger_output_mode == OM_DAEMON)
@@ -99,6 +122,184 @@ _stderr_log_with_level(const char *level_name, int level, const char *fmt, va_li
 	}
 }
 
+/*
+ * Format a log line and push it into the asynchronous logging pipe.
+ *
+ * Complete lines of up to PIPE_BUF bytes are written atomically; with
+ * O_NONBLOCK set, the write either succeeds in full or fails immediately
+ * with EAGAIN if the writer process has fallen behind. In the latter case
+ * the message is dropped (drop-newest policy) rather than blocking the
+ * caller; the number of dropped messages is reported as soon as buffer
+ * space becomes available again, so a gap in the log is always visible.
+ */
+static void
+_async_log_write(const char *level_name, const char *fmt, va_list ap)
+{
+	char		line[PIPE_BUF];
+	int			len = 0;
+
+	if (logger_output_mode == OM_DAEMON)
+	{
+		char		timebuf[100];
+		time_t		t;
+		struct tm  *tm;
+
+		time(&t);
+		tm = localtime(&t);
+		strftime(timebuf, sizeof(timebuf), "[%Y-%m-%d %H:%M:%S]", tm);
+		len = snprintf(line, sizeof(line), "%s [%s] ", timebuf, level_name);
+	}
+	else
+	{
+		len = snprintf(line, sizeof(line), "%s: ", level_name);
+	}
+
+	len += vsnprintf(line + len, sizeof(line) - len - 1, fmt, ap);
+
+	/* truncate overlong messages so the pipe write remains atomic */
+	if (len > (int) sizeof(line) - 2)
+		len = (int) sizeof(line) - 2;
+
+	line[len++] = '\n';
+
+	if (async_dropped_messages > 0)
+	{
+		char		notice[100];
+		int			notice_len;
+
+		notice_len = snprintf(notice, sizeof(notice),
+							  "[WARNING] %li log messages dropped (log buffer full)\n",
+							  async_dropped_messages);
+
+		if (write(async_log_fd, notice, notice_len) < 0)
+		{
+			/* still no buffer space - drop this message too */
+			async_dropped_messages++;
+			return;
+		}
+
+		async_dropped_messages = 0;
+	}
+
+	if (write(async_log_fd, line, len) < 0)
+		async_dropped_messages++;
+}
+
+
+/*
+ * Switch stderr logging to asynchronous mode.
+ *
+ * A writer process is forked which drains the logging pipe and performs
+ * the actual (potentially blocking) writes to stderr, which by this point
+ * may have been redirected to the configured log file. The writer
+ * terminates when the parent closes its end of the pipe on exit, after
+ * writing out anything still buffered.
+ *
+ * Not used for syslog output, which performs its own buffering.
+ */
+bool
+logger_enable_async(void)
+{
+	int			pipe_fds[2];
+	pid_t		writer_pid;
+
+	if (async_logging == true)
+		return true;
+
+	/* asynchronous logging is only useful for a long-running daemon */
+	if (logger_output_mode != OM_DAEMON)
+		return false;
+
+	if (pipe(pipe_fds) != 0)
+	{
+		stderr_log_warning(_("unable to create logging pipe: %s\n"), strerror(errno));
+		return false;
+	}
+
+	writer_pid = fork();
+
+	switch (writer_pid)
+	{
+		case -1:
+			stderr_log_warning(_("unable to fork log writer process: %s\n"), strerror(errno));
+			close(pipe_fds[0]);
+			close(pipe_fds[1]);
+			return false;
+
+		case 0:
+		{
+			/* writer process */
+			char		buf[PIPE_BUF];
+			ssize_t		bytes_read;
+
+			close(pipe_fds[1]);
+
+			/*
+			 * Signals intended for the daemon are irrelevant here; the
+			 * writer exits when the pipe is closed, ensuring buffered
+			 * messages are written out during shutdown.
+			 */
+			signal(SIGHUP, SIG_IGN);
+			signal(SIGINT, SIG_IGN);
+			signal(SIGTERM, SIG_IGN);
+
+			for (;;)
+			{
+				ssize_t		bytes_written = 0;
+
+				bytes_read = read(pipe_fds[0], buf, sizeof(buf));
+
+				if (bytes_read == 0)
+					break;
+
+				if (bytes_read < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					break;
+				}
+
+				while (bytes_written < bytes_read)
+				{
+					ssize_t		n = write(fileno(stderr),
+										  buf + bytes_written,
+										  bytes_read - bytes_written);
+
+					if (n < 0)
+					{
+						if (errno == EINTR)
+							continue;
+						break;
+					}
+
+					bytes_written += n;
+				}
+			}
+
+			_exit(0);
+		}
+
+		default:
+			break;
+	}
+
+	close(pipe_fds[0]);
+
+	if (fcntl(pipe_fds[1], F_SETFL, O_NONBLOCK) != 0)
+	{
+		stderr_log_warning(_("unable to set logging pipe non-blocking: %s\n"), strerror(errno));
+		close(pipe_fds[1]);
+		return false;
+	}
+
+	async_log_fd = pipe_fds[1];
+	async_writer_pid = writer_pid;
+	async_logging = true;
+
+	return true;
+}
+
+
 void
 log_hint(const char *fmt,...)
 {
@@ -293,6 +494,20 @@ logger_init(t_configuration_options *opts, const char *ident)
 bool
 logger_shutdown(void)
 {
+	/*
+	 * Closing the pipe signals the writer process to terminate; wait for
+	 * it so any buffered messages are written out before we exit.
+	 */
+	if (async_logging == true)
+	{
+		async_logging = false;
+		close(async_log_fd);
+		async_log_fd = -1;
+
+		(void) waitpid(async_writer_pid, NULL, 0);
+		async_writer_pid = -1;
+	}
+
 #ifdef HAVE_SYSLOG
 	if (log_type == REPMGR_SYSLOG)
 		closelog();
@@ -123,6 +123,7 @@ int			detect_log_level(const char *level);
 /* Logger initialisation and shutdown */
 
 bool		logger_init(t_configuration_options *opts, const char *ident);
+bool		logger_enable_async(void);
 
 bool		logger_shutdown(void);
 
@@ -1,2 +1,22 @@
 -- complain if script is sourced in psql, rather than via CREATE EXTENSION
 \echo Use "CREATE EXTENSION repmgr" to load this file. \quit
+
+CREATE FUNCTION set_repmgrd_timings(TEXT)
+  RETURNS VOID
+  AS 'MODULE_PATHNAME', 'set_repmgrd_timings'
+  LANGUAGE C STRICT;
+
+CREATE FUNCTION get_repmgrd_timings()
+  RETURNS TEXT
+  AS 'MODULE_PATHNAME', 'get_repmgrd_timings'
+  LANGUAGE C STRICT;
+
+CREATE FUNCTION set_repmgrd_lag_stats(TEXT)
+  RETURNS VOID
+  AS 'MODULE_PATHNAME', 'set_repmgrd_lag_stats'
+  LANGUAGE C STRICT;
+
+CREATE FUNCTION get_repmgrd_lag_stats()
+  RETURNS TEXT
+  AS 'MODULE_PATHNAME', 'get_repmgrd_lag_stats'
+  LANGUAGE C STRICT;
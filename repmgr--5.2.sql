@@ -188,6 +188,26 @@ CREATE FUNCTION get_wal_receiver_pid()
   AS 'MODULE_PATHNAME', 'get_wal_receiver_pid'
   LANGUAGE C STRICT;
 
+CREATE FUNCTION set_repmgrd_timings(TEXT)
+  RETURNS VOID
+  AS 'MODULE_PATHNAME', 'set_repmgrd_timings'
+  LANGUAGE C STRICT;
+
+CREATE FUNCTION get_repmgrd_timings()
+  RETURNS TEXT
+  AS 'MODULE_PATHNAME', 'get_repmgrd_timings'
+  LANGUAGE C STRICT;
+
+CREATE FUNCTION set_repmgrd_lag_stats(TEXT)
+  RETURNS VOID
+  AS 'MODULE_PATHNAME', 'set_repmgrd_lag_stats'
+  LANGUAGE C STRICT;
+
+CREATE FUNCTION get_repmgrd_lag_stats()
+  RETURNS TEXT
+  AS 'MODULE_PATHNAME', 'get_repmgrd_lag_stats'
+  LANGUAGE C STRICT;
+
 
 
 
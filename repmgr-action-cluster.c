@@ -41,6 +41,13 @@ typedef enum
 
 #define EVENT_HEADER_COUNT 6
 
+/* number of rows fetched per batch by "cluster event" (see do_cluster_event()) */
+#define CLUSTER_EVENT_BATCH_SIZE 1000
+
+/* "cluster cleanup" incremental deletion parameters (see do_cluster_cleanup()) */
+#define CLUSTER_CLEANUP_BATCH_SIZE 10000
+#define CLUSTER_CLEANUP_BATCH_PAUSE 1	/* seconds */
+
 typedef enum
 {
 	EV_NODE_ID = 0,
@@ -56,8 +63,9 @@ struct ColHeader headers_show[SHOW_HEADER_COUNT];
 struct ColHeader headers_event[EVENT_HEADER_COUNT];
 
 static int	build_cluster_matrix(t_node_matrix_rec ***matrix_rec_dest, ItemList *warnings, int *error_code);
-static int	build_cluster_crosscheck(t_node_status_cube ***cube_dest, ItemList *warnings, int *error_code);
-static void cube_set_node_status(t_node_status_cube **cube, int n, int node_id, int matrix_node_id, int connection_node_id, int connection_status);
+static int	build_cluster_crosscheck(t_crosscheck_matrix *matrix, ItemList *warnings, int *error_code);
+static int	crosscheck_node_index(t_crosscheck_matrix *matrix, int node_id);
+static void crosscheck_set_edge_status(t_crosscheck_matrix *matrix, int origin_node_id, int destination_node_id, int connection_status);
 
 /*
  * CLUSTER SHOW
@@ -166,6 +174,13 @@ do_cluster_show(void)
 	 * unreachable.
 	 */
 
+	/*
+	 * Race all node connection attempts concurrently, so an unreachable
+	 * node delays the command by roughly one "connect_timeout" in total,
+	 * rather than one per unreachable node.
+	 */
+	establish_node_connections_parallel(&nodes);
+
 	for (cell = nodes.head; cell; cell = cell->next)
 	{
 		PQExpBufferData node_status;
@@ -181,8 +196,6 @@ do_cluster_show(void)
 
 		init_replication_info(cell->node_info->replication_info);
 
-		cell->node_info->conn = establish_db_connection_quiet(cell->node_info->conninfo);
-
 		if (PQstatus(cell->node_info->conn) != CONNECTION_OK)
 		{
 			connection_error_found = true;
@@ -227,6 +240,59 @@ do_cluster_show(void)
 		PQfinish(cell->node_info->conn);
 		cell->node_info->conn = NULL;
 
+		/*
+		 * In "json-lines" mode, emit each node's record as soon as its
+		 * status has been resolved, so consumers receive the first results
+		 * without waiting for the whole cluster to be probed; no column
+		 * width calculation is needed.
+		 */
+		if (runtime_options.output_mode == OM_JSON_LINES)
+		{
+			PQExpBufferData json_line;
+
+			initPQExpBuffer(&json_line);
+
+			appendPQExpBuffer(&json_line,
+							  "{\"node_id\":%i,\"node_name\":",
+							  cell->node_info->node_id);
+			append_json_string(&json_line, cell->node_info->node_name);
+
+			appendPQExpBufferStr(&json_line, ",\"role\":");
+			append_json_string(&json_line, get_node_type_string(cell->node_info->type));
+
+			appendPQExpBufferStr(&json_line, ",\"status\":");
+			append_json_string(&json_line, cell->node_info->details);
+
+			appendPQExpBufferStr(&json_line, ",\"upstream\":");
+			append_json_string(&json_line, cell->node_info->upstream_node_name);
+
+			appendPQExpBufferStr(&json_line, ",\"location\":");
+			append_json_string(&json_line, cell->node_info->location);
+
+			appendPQExpBuffer(&json_line,
+							  ",\"priority\":%i",
+							  cell->node_info->priority);
+
+			/* the witness node's timeline ID is irrelevant; not available pre-9.6 */
+			appendPQExpBufferStr(&json_line, ",\"timeline\":");
+			if (cell->node_info->type == WITNESS || headers_show[SHOW_TIMELINE_ID].display == false)
+				appendPQExpBufferStr(&json_line, "null");
+			else
+				append_json_string(&json_line, cell->node_info->replication_info->timeline_id_str);
+
+			appendPQExpBufferStr(&json_line, ",\"conninfo\":");
+			append_json_string(&json_line, cell->node_info->conninfo);
+
+			appendPQExpBufferChar(&json_line, '}');
+
+			puts(json_line.data);
+			fflush(stdout);
+
+			termPQExpBuffer(&json_line);
+
+			continue;
+		}
+
 		initPQExpBuffer(&buf);
 		appendPQExpBuffer(&buf, "%i", cell->node_info->node_id);
 		headers_show[SHOW_ID].cur_length = strlen(buf.data);
@@ -279,6 +345,10 @@ do_cluster_show(void)
 
 	for (cell = nodes.head; cell; cell = cell->next)
 	{
+		/* in "json-lines" mode, records were already emitted during collection */
+		if (runtime_options.output_mode == OM_JSON_LINES)
+			break;
+
 		if (runtime_options.output_mode == OM_CSV)
 		{
 			int			connection_status = (cell->node_info->node_status == NODE_STATUS_UP) ? 0 : -1;
@@ -334,7 +404,8 @@ do_cluster_show(void)
 	PQfinish(conn);
 
 	/* emit any warnings */
-	if (warnings.head != NULL && runtime_options.terse == false && runtime_options.output_mode != OM_CSV)
+	if (warnings.head != NULL && runtime_options.terse == false &&
+		runtime_options.output_mode != OM_CSV && runtime_options.output_mode != OM_JSON_LINES)
 	{
 
 		ItemListCell *cell = NULL;
@@ -385,6 +456,7 @@ do_cluster_show(void)
  *   --all
  *   --node-[id|name]
  *   --event
+ *   --since/--until
  *   --csv
  *   --compact
  */
@@ -396,34 +468,15 @@ do_cluster_event(void)
 	PGresult   *res;
 	int			i = 0;
 	int			column_count = EVENT_HEADER_COUNT;
+	int			fetched = 0;
+	int			batch_size = 0;
+	bool		batch_complete = false;
+	bool		headers_initialized = false;
+	char		cursor_timestamp[MAXLEN] = "";
+	int			cursor_node_id = UNKNOWN_NODE_ID;
 
 	conn = establish_db_connection(config_file_options.conninfo, true);
 
-	res = get_event_records(conn,
-							runtime_options.node_id,
-							runtime_options.node_name,
-							runtime_options.event,
-							runtime_options.all,
-							runtime_options.limit);
-
-	if (PQresultStatus(res) != PGRES_TUPLES_OK)
-	{
-		log_error(_("unable to execute event query:\n  %s"),
-				  PQerrorMessage(conn));
-		PQclear(res);
-		PQfinish(conn);
-		exit(ERR_DB_QUERY);
-	}
-
-	if (PQntuples(res) == 0)
-	{
-		/* print this message directly, rather than as a log line */
-		printf(_("no matching events found\n"));
-		PQclear(res);
-		PQfinish(conn);
-		return;
-	}
-
 	strncpy(headers_event[EV_NODE_ID].title, _("Node ID"), MAXLEN);
 	strncpy(headers_event[EV_NODE_NAME].title, _("Name"), MAXLEN);
 	strncpy(headers_event[EV_EVENT].title, _("Event"), MAXLEN);
@@ -439,94 +492,161 @@ do_cluster_event(void)
 	if (runtime_options.compact == true || runtime_options.output_mode == OM_CSV)
 		column_count --;
 
-	for (i = 0; i < column_count; i++)
+	/*
+	 * Retrieve the event records in batches, keyset-paginated on
+	 * (event_timestamp, node_id), and stream each batch to the output as it
+	 * arrives rather than materializing the entire result set in memory.
+	 *
+	 * Column widths are calculated from the first batch only; a longer value
+	 * in a subsequent batch will simply expand its own row.
+	 */
+	while (batch_complete == false)
 	{
-		headers_event[i].max_length = strlen(headers_event[i].title);
-	}
+		batch_size = CLUSTER_EVENT_BATCH_SIZE;
 
-	for (i = 0; i < PQntuples(res); i++)
-	{
-		int			j;
+		if (runtime_options.all == false
+			&& (runtime_options.limit - fetched) < batch_size)
+		{
+			batch_size = runtime_options.limit - fetched;
+		}
+
+		res = get_event_records(conn,
+								runtime_options.node_id,
+								runtime_options.node_name,
+								runtime_options.event,
+								runtime_options.since,
+								runtime_options.until,
+								cursor_timestamp,
+								cursor_node_id,
+								batch_size);
+
+		if (PQresultStatus(res) != PGRES_TUPLES_OK)
+		{
+			log_error(_("unable to execute event query:\n  %s"),
+					  PQerrorMessage(conn));
+			PQclear(res);
+			PQfinish(conn);
+			exit(ERR_DB_QUERY);
+		}
 
-		for (j = 0; j < column_count; j++)
+		if (PQntuples(res) == 0)
 		{
-			headers_event[j].cur_length = strlen(PQgetvalue(res, i, j));
-			if (headers_event[j].cur_length > headers_event[j].max_length)
+			if (fetched == 0)
 			{
-				headers_event[j].max_length = headers_event[j].cur_length;
+				/* print this message directly, rather than as a log line */
+				printf(_("no matching events found\n"));
 			}
+			PQclear(res);
+			break;
 		}
 
-	}
-
-	if (runtime_options.output_mode == OM_TEXT)
-	{
-		for (i = 0; i < column_count; i++)
+		if (headers_initialized == false)
 		{
-			if (i == 0)
-				printf(" ");
-			else
-				printf(" | ");
+			for (i = 0; i < column_count; i++)
+			{
+				headers_event[i].max_length = strlen(headers_event[i].title);
+			}
 
-			printf("%-*s",
-				   headers_event[i].max_length,
-				   headers_event[i].title);
-		}
-		printf("\n");
-		printf("-");
-		for (i = 0; i < column_count; i++)
-		{
-			int			j;
+			for (i = 0; i < PQntuples(res); i++)
+			{
+				int			j;
 
-			for (j = 0; j < headers_event[i].max_length; j++)
-				printf("-");
+				for (j = 0; j < column_count; j++)
+				{
+					headers_event[j].cur_length = strlen(PQgetvalue(res, i, j));
+					if (headers_event[j].cur_length > headers_event[j].max_length)
+					{
+						headers_event[j].max_length = headers_event[j].cur_length;
+					}
+				}
 
-			if (i < (column_count - 1))
-				printf("-+-");
-			else
+			}
+
+			if (runtime_options.output_mode == OM_TEXT)
+			{
+				for (i = 0; i < column_count; i++)
+				{
+					if (i == 0)
+						printf(" ");
+					else
+						printf(" | ");
+
+					printf("%-*s",
+						   headers_event[i].max_length,
+						   headers_event[i].title);
+				}
+				printf("\n");
 				printf("-");
-		}
+				for (i = 0; i < column_count; i++)
+				{
+					int			j;
 
-		printf("\n");
-	}
+					for (j = 0; j < headers_event[i].max_length; j++)
+						printf("-");
 
-	for (i = 0; i < PQntuples(res); i++)
-	{
-		int			j;
+					if (i < (column_count - 1))
+						printf("-+-");
+					else
+						printf("-");
+				}
 
-		if (runtime_options.output_mode == OM_CSV)
+				printf("\n");
+			}
+
+			headers_initialized = true;
+		}
+
+		for (i = 0; i < PQntuples(res); i++)
 		{
-			for (j = 0; j < column_count; j++)
+			int			j;
+
+			if (runtime_options.output_mode == OM_CSV)
 			{
-				printf("%s", PQgetvalue(res, i, j));
-				if ((j + 1) < column_count)
+				for (j = 0; j < column_count; j++)
 				{
-					printf(",");
+					printf("%s", PQgetvalue(res, i, j));
+					if ((j + 1) < column_count)
+					{
+						printf(",");
+					}
 				}
 			}
-		}
-		else
-		{
-			printf(" ");
-			for (j = 0; j < column_count; j++)
+			else
 			{
-				printf("%-*s",
-					   headers_event[j].max_length,
-					   PQgetvalue(res, i, j));
+				printf(" ");
+				for (j = 0; j < column_count; j++)
+				{
+					printf("%-*s",
+						   headers_event[j].max_length,
+						   PQgetvalue(res, i, j));
 
-				if (j < (column_count - 1))
-					printf(" | ");
+					if (j < (column_count - 1))
+						printf(" | ");
+				}
 			}
+
+			printf("\n");
 		}
 
-		printf("\n");
-	}
+		/* note the keyset cursor position of the last record retrieved */
+		i = PQntuples(res) - 1;
+		strncpy(cursor_timestamp, PQgetvalue(res, i, EVENT_HEADER_COUNT), MAXLEN);
+		cursor_node_id = atoi(PQgetvalue(res, i, EV_NODE_ID));
 
-	PQclear(res);
+		fetched += PQntuples(res);
+
+		if (PQntuples(res) < batch_size)
+			batch_complete = true;
+
+		if (runtime_options.all == false && fetched >= runtime_options.limit)
+			batch_complete = true;
+
+		PQclear(res);
+	}
 
 	PQfinish(conn);
 
-	if (runtime_options.output_mode == OM_TEXT)
+	if (runtime_options.output_mode == OM_TEXT && fetched > 0)
 		puts("");
 }
 
@@ -537,13 +657,13 @@ do_cluster_crosscheck(void)
 	int			i = 0,
 				n = 0;
 
-	t_node_status_cube **cube;
+	t_crosscheck_matrix matrix = {0, NULL, NULL};
 
 	bool		connection_error_found = false;
 	int			error_code = SUCCESS;
 	ItemList	warnings = {NULL, NULL};
 
-	n = build_cluster_crosscheck(&cube, &warnings, &error_code);
+	n = build_cluster_crosscheck(&matrix, &warnings, &error_code);
 
 	if (runtime_options.output_mode == OM_CSV)
 	{
@@ -552,19 +672,11 @@ do_cluster_crosscheck(void)
 			int j;
 			for (j = 0; j < n; j++)
 			{
-				int			max_node_status = -2;
-				int			node_ix = 0;
-
-				for (node_ix = 0; node_ix < n; node_ix++)
-				{
-					int			node_status = cube[node_ix]->matrix_list_rec[i]->node_status_list[j]->node_status;
+				int			max_node_status = matrix.edge_status[i * n + j];
 
-					if (node_status > max_node_status)
-						max_node_status = node_status;
-				}
 				printf("%i,%i,%i\n",
-					   cube[i]->node_id,
-					   cube[j]->node_id,
+					   matrix.nodes[i].node_id,
+					   matrix.nodes[j].node_id,
 					   max_node_status);
 
 				if (max_node_status == -1)
@@ -591,7 +703,7 @@ do_cluster_crosscheck(void)
 
 		for (i = 0; i < n; i++)
 		{
-			maxlen_snprintf(headers_crosscheck[header_id].title, "%i", cube[i]->node_id);
+			maxlen_snprintf(headers_crosscheck[header_id].title, "%i", matrix.nodes[i].node_id);
 			header_id++;
 		}
 
@@ -611,9 +723,9 @@ do_cluster_crosscheck(void)
 
 		for (i = 0; i < n; i++)
 		{
-			if (strlen(cube[i]->node_name) > headers_crosscheck[0].max_length)
+			if (strlen(matrix.nodes[i].node_name) > headers_crosscheck[0].max_length)
 			{
-				headers_crosscheck[0].max_length = strlen(cube[i]->node_name);
+				headers_crosscheck[0].max_length = strlen(matrix.nodes[i].node_name);
 			}
 		}
 
@@ -625,38 +737,29 @@ do_cluster_crosscheck(void)
 
 			printf(" %-*s | %-*i ",
 				   headers_crosscheck[0].max_length,
-				   cube[i]->node_name,
+				   matrix.nodes[i].node_name,
 				   headers_crosscheck[1].max_length,
-				   cube[i]->node_id);
+				   matrix.nodes[i].node_id);
 
 			for (column_node_ix = 0; column_node_ix < n; column_node_ix++)
 			{
-				int			max_node_status = -2;
-				int			node_ix = 0;
-
-				char		c;
-
 				/*
-				 * The value of entry (i,j) is equal to the maximum value of all
-				 * the (i,j,k). Indeed:
+				 * The value of entry (i,j) is the maximum status any
+				 * observing node reported for the pair (see
+				 * crosscheck_set_edge_status()). Indeed:
 				 *
-				 * - if one of the (i,j,k) is 0 (node up), then 0 (the node is
-				 * up);
+				 * - if one of the observations is 0 (node up), then 0 (the
+				 * node is up);
 				 *
-				 * - if the (i,j,k) are either -1 (down) or -2 (unknown), then -1
-				 * (the node is down);
+				 * - if the observations are either -1 (down) or -2
+				 * (unknown), then -1 (the node is down);
 				 *
-				 * - if all the (i,j,k) are -2 (unknown), then -2 (the node is in
-				 * an unknown state).
+				 * - if all the observations are -2 (unknown), then -2 (the
+				 * node is in an unknown state).
 				 */
+				int			max_node_status = matrix.edge_status[i * n + column_node_ix];
 
-				for (node_ix = 0; node_ix < n; node_ix++)
-				{
-					int			node_status = cube[node_ix]->matrix_list_rec[i]->node_status_list[column_node_ix]->node_status;
-
-					if (node_status > max_node_status)
-						max_node_status = node_status;
-				}
+				char		c;
 
 				switch (max_node_status)
 				{
@@ -691,29 +794,9 @@ do_cluster_crosscheck(void)
 
 	}
 
-	/* clean up allocated cube array */
-	{
-		int			h,
-					j;
-
-		for (h = 0; h < n; h++)
-		{
-			for (i = 0; i < n; i++)
-			{
-				for (j = 0; j < n; j++)
-				{
-					free(cube[h]->matrix_list_rec[i]->node_status_list[j]);
-				}
-				free(cube[h]->matrix_list_rec[i]->node_status_list);
-				free(cube[h]->matrix_list_rec[i]);
-			}
-
-			free(cube[h]->matrix_list_rec);
-			free(cube[h]);
-		}
-
-		free(cube);
-	}
+	/* clean up allocated matrix */
+	pg_free(matrix.nodes);
+	pg_free(matrix.edge_status);
 
 	/* errors detected by build_cluster_crosscheck() have priority */
 	if (connection_error_found == true)
@@ -912,7 +995,9 @@ build_cluster_matrix(t_node_matrix_rec ***matrix_rec_dest, ItemList *warnings, i
 	NodeInfoListCell *cell = NULL;
 
 	PQExpBufferData command;
-	PQExpBufferData command_output;
+
+	t_parallel_command *remote_commands;
+	int			remote_command_count = 0;
 
 	t_node_matrix_rec **matrix_rec_list;
 
@@ -984,18 +1069,21 @@ build_cluster_matrix(t_node_matrix_rec ***matrix_rec_dest, ItemList *warnings, i
 		i++;
 	}
 
-	/* Fetch `repmgr cluster show --csv` output for each node */
-	i = 0;
+	/*
+	 * Probe each node's database connection, and assemble a
+	 * `repmgr cluster show --csv` invocation for each reachable remote node.
+	 * The assembled commands are then executed concurrently, so total
+	 * execution time approximates that of the slowest single node rather
+	 * than the sum of all nodes.
+	 */
+	remote_commands = (t_parallel_command *) pg_malloc0(sizeof(t_parallel_command) * nodes.node_count);
 
 	for (cell = nodes.head; cell; cell = cell->next)
 	{
 		int			connection_status = 0;
 		t_conninfo_param_list remote_conninfo = T_CONNINFO_PARAM_LIST_INITIALIZER;
-		char	   *host = NULL,
-				   *p = NULL;
+		char	   *host = NULL;
 		int			connection_node_id = cell->node_info->node_id;
-		int			x,
-					y;
 		PGconn	   *node_conn = NULL;
 
 		initialize_conninfo_params(&remote_conninfo, false);
@@ -1062,19 +1150,33 @@ build_cluster_matrix(t_node_matrix_rec ***matrix_rec_dest, ItemList *warnings, i
 		}
 		appendPQExpBufferChar(&command, '"');
 
-		log_verbose(LOG_DEBUG, "build_cluster_matrix(): executing:\n  %s", command.data);
-
-		initPQExpBuffer(&command_output);
+		remote_commands[remote_command_count].id = connection_node_id;
+		initPQExpBuffer(&remote_commands[remote_command_count].command);
 
-		(void) remote_command(host,
-							  runtime_options.remote_user,
-							  command.data,
-							  config_file_options.ssh_options,
-							  &command_output);
+		make_remote_command(host,
+							runtime_options.remote_user,
+							command.data,
+							config_file_options.ssh_options,
+							&remote_commands[remote_command_count].command);
 
-		p = command_output.data;
+		remote_command_count++;
 
 		termPQExpBuffer(&command);
+		PQfinish(node_conn);
+		free_conninfo_params(&remote_conninfo);
+	}
+
+	/* execute all remote commands concurrently */
+	(void) execute_parallel_commands(remote_commands,
+									 remote_command_count,
+									 PARALLEL_COMMAND_MAX_WORKERS);
+
+	for (i = 0; i < remote_command_count; i++)
+	{
+		int			connection_node_id = remote_commands[i].id;
+		char	   *p = remote_commands[i].output.data;
+		int			x,
+					y;
 
 		/* no output returned - probably SSH error */
 		if (p[0] == '\0' || p[0] == '\n')
@@ -1117,11 +1219,12 @@ build_cluster_matrix(t_node_matrix_rec ***matrix_rec_dest, ItemList *warnings, i
 			}
 		}
 
-		termPQExpBuffer(&command_output);
-		PQfinish(node_conn);
-		free_conninfo_params(&remote_conninfo);
+		termPQExpBuffer(&remote_commands[i].command);
+		termPQExpBuffer(&remote_commands[i].output);
 	}
 
+	pg_free(remote_commands);
+
 	*matrix_rec_dest = matrix_rec_list;
 
 	node_count = nodes.node_count;
@@ -1132,16 +1235,15 @@ build_cluster_matrix(t_node_matrix_rec ***matrix_rec_dest, ItemList *warnings, i
 
 
 static int
-build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, int *error_code)
+build_cluster_crosscheck(t_crosscheck_matrix *matrix, ItemList *warnings, int *error_code)
 {
 	PGconn	   *conn = NULL;
-	int			h,
-				i,
+	int			i,
 				j;
 	NodeInfoList nodes = T_NODE_INFO_LIST_INITIALIZER;
 	NodeInfoListCell *cell = NULL;
 
-	t_node_status_cube **cube;
+	t_parallel_command *matrix_commands;
 
 	int			node_count = 0;
 
@@ -1170,70 +1272,46 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 	}
 
 	/*
-	 * Allocate an empty cube matrix structure
+	 * Allocate the aggregated status matrix: one node entry per node plus
+	 * a single flat array with one byte per directed node pair.
 	 *
-	 * -2 == NULL -1 == Error 0 == OK
+	 * -2 == unknown -1 == Error 0 == OK
 	 */
 
-	cube = (t_node_status_cube **) pg_malloc(sizeof(t_node_status_cube *) * nodes.node_count);
+	matrix->node_count = nodes.node_count;
+	matrix->nodes = (t_crosscheck_node *) pg_malloc0(sizeof(t_crosscheck_node) * nodes.node_count);
+	matrix->edge_status = (signed char *) pg_malloc(sizeof(signed char) * nodes.node_count * nodes.node_count);
 
-	h = 0;
+	/* default unknown */
+	memset(matrix->edge_status, -2, sizeof(signed char) * nodes.node_count * nodes.node_count);
+
+	i = 0;
 
 	for (cell = nodes.head; cell; cell = cell->next)
 	{
-		NodeInfoListCell *cell_i = NULL;
-
-		cube[h] = (t_node_status_cube *) pg_malloc(sizeof(t_node_status_cube));
-		cube[h]->node_id = cell->node_info->node_id;
-		strncpy(cube[h]->node_name, cell->node_info->node_name, sizeof(cube[h]->node_name));
-
-		cube[h]->matrix_list_rec = (t_node_matrix_rec **) pg_malloc(sizeof(t_node_matrix_rec) * nodes.node_count);
-
-		i = 0;
-		for (cell_i = nodes.head; cell_i; cell_i = cell_i->next)
-		{
-			NodeInfoListCell *cell_j;
-
-			cube[h]->matrix_list_rec[i] = (t_node_matrix_rec *) pg_malloc0(sizeof(t_node_matrix_rec));
-			cube[h]->matrix_list_rec[i]->node_id = cell_i->node_info->node_id;
-
-			/* we don't need the name here */
-			cube[h]->matrix_list_rec[i]->node_name[0] = '\0';
-
-			cube[h]->matrix_list_rec[i]->node_status_list = (t_node_status_rec **) pg_malloc0(sizeof(t_node_status_rec *) * nodes.node_count);
-
-			j = 0;
+		matrix->nodes[i].node_id = cell->node_info->node_id;
+		strncpy(matrix->nodes[i].node_name, cell->node_info->node_name, sizeof(matrix->nodes[i].node_name));
 
-			for (cell_j = nodes.head; cell_j; cell_j = cell_j->next)
-			{
-				cube[h]->matrix_list_rec[i]->node_status_list[j] = (t_node_status_rec *) pg_malloc0(sizeof(t_node_status_rec));
-				cube[h]->matrix_list_rec[i]->node_status_list[j]->node_id = cell_j->node_info->node_id;
-				cube[h]->matrix_list_rec[i]->node_status_list[j]->node_status = -2; /* default unknown */
-
-				j++;
-			}
-
-			i++;
-		}
-
-		h++;
+		i++;
 	}
 
 
 	/*
 	 * Build the connection cube
+	 *
+	 * Each node is asked to run `repmgr cluster matrix --csv` (which itself
+	 * probes every other node); the per-node invocations are assembled
+	 * first, then executed concurrently, so the crosscheck's wall-clock
+	 * time approximates that of the slowest single node rather than
+	 * growing with the number of nodes.
 	 */
+	matrix_commands = (t_parallel_command *) pg_malloc0(sizeof(t_parallel_command) * nodes.node_count);
+
 	i = 0;
 
 	for (cell = nodes.head; cell; cell = cell->next)
 	{
-		int			remote_node_id = UNKNOWN_NODE_ID;
 		PQExpBufferData command;
-		PQExpBufferData command_output;
-
-		char	   *p = NULL;
-
-		remote_node_id = cell->node_info->node_id;
 
 		initPQExpBuffer(&command);
 
@@ -1253,12 +1331,13 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 								 " -L NOTICE");
 		}
 
-		initPQExpBuffer(&command_output);
+		matrix_commands[i].id = cell->node_info->node_id;
+		initPQExpBuffer(&matrix_commands[i].command);
 
-		if (cube[i]->node_id == config_file_options.node_id)
+		if (matrix->nodes[i].node_id == config_file_options.node_id)
 		{
-			(void) local_command_simple(command.data,
-										&command_output);
+			appendPQExpBufferStr(&matrix_commands[i].command,
+								 command.data);
 		}
 		else
 		{
@@ -1280,13 +1359,11 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 
 			host = param_get(&remote_conninfo, "host");
 
-			log_verbose(LOG_DEBUG, "build_cluster_crosscheck(): executing\n  %s", quoted_command.data);
-
-			(void) remote_command(host,
-								  runtime_options.remote_user,
-								  quoted_command.data,
-								  config_file_options.ssh_options,
-								  &command_output);
+			make_remote_command(host,
+								runtime_options.remote_user,
+								quoted_command.data,
+								config_file_options.ssh_options,
+								&matrix_commands[i].command);
 
 			free_conninfo_params(&remote_conninfo);
 			termPQExpBuffer(&quoted_command);
@@ -1294,14 +1371,27 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 
 		termPQExpBuffer(&command);
 
-		p = command_output.data;
+		i++;
+	}
+
+	/* execute all matrix commands concurrently */
+	(void) execute_parallel_commands(matrix_commands,
+									 nodes.node_count,
+									 PARALLEL_COMMAND_MAX_WORKERS);
+
+	for (i = 0; i < nodes.node_count; i++)
+	{
+		int			remote_node_id = matrix_commands[i].id;
+		char	   *p = matrix_commands[i].output.data;
+
+		termPQExpBuffer(&matrix_commands[i].command);
 
 		if (p[0] == '\0' || p[0] == '\n')
 		{
 			item_list_append_format(warnings,
 									"node %i inaccessible via SSH",
 									remote_node_id);
-			termPQExpBuffer(&command_output);
+			termPQExpBuffer(&matrix_commands[i].output);
 			*error_code = ERR_BAD_SSH;
 			continue;
 		}
@@ -1314,22 +1404,15 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 
 			if (sscanf(p, "%d,%d,%d", &matrix_rec_node_id, &node_status_node_id, &node_status) != 3)
 			{
-				cube_set_node_status(cube,
-									 nodes.node_count,
-									 remote_node_id,
-									 matrix_rec_node_id,
-									 node_status_node_id,
-									 -2);
+				/* "unknown" is the default, so nothing to fold in */
 				*error_code = ERR_INTERNAL;
 			}
 			else
 			{
-				cube_set_node_status(cube,
-									 nodes.node_count,
-									 remote_node_id,
-									 matrix_rec_node_id,
-									 node_status_node_id,
-									 node_status);
+				crosscheck_set_edge_status(matrix,
+										   matrix_rec_node_id,
+										   node_status_node_id,
+										   node_status);
 			}
 
 			while (*p && (*p != '\n'))
@@ -1337,12 +1420,10 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 			if (*p == '\n')
 				p++;
 		}
-		termPQExpBuffer(&command_output);
-
-		i++;
+		termPQExpBuffer(&matrix_commands[i].output);
 	}
 
-	*dest_cube = cube;
+	pg_free(matrix_commands);
 
 	node_count = nodes.node_count;
 
@@ -1352,35 +1433,41 @@ build_cluster_crosscheck(t_node_status_cube ***dest_cube, ItemList *warnings, in
 }
 
 
-static void
-cube_set_node_status(t_node_status_cube **cube, int n, int execute_node_id, int matrix_node_id, int connection_node_id, int connection_status)
+static int
+crosscheck_node_index(t_crosscheck_matrix *matrix, int node_id)
 {
-	int			h,
-				i,
-				j;
-
+	int			i;
 
-	for (h = 0; h < n; h++)
+	for (i = 0; i < matrix->node_count; i++)
 	{
-		if (cube[h]->node_id == execute_node_id)
-		{
-			for (i = 0; i < n; i++)
-			{
-				if (cube[h]->matrix_list_rec[i]->node_id == matrix_node_id)
-				{
-					for (j = 0; j < n; j++)
-					{
-						if (cube[h]->matrix_list_rec[i]->node_status_list[j]->node_id == connection_node_id)
-						{
-							cube[h]->matrix_list_rec[i]->node_status_list[j]->node_status = connection_status;
-							break;
-						}
-					}
-					break;
-				}
-			}
-		}
+		if (matrix->nodes[i].node_id == node_id)
+			return i;
 	}
+
+	return -1;
+}
+
+
+/*
+ * Fold one observation of the (origin, destination) pair into the
+ * aggregated matrix; the stored value is the maximum status reported by
+ * any observing node, so a single "up" report outweighs any number of
+ * "down" or "unknown" ones.
+ */
+static void
+crosscheck_set_edge_status(t_crosscheck_matrix *matrix, int origin_node_id, int destination_node_id, int connection_status)
+{
+	int			i = crosscheck_node_index(matrix, origin_node_id);
+	int			j = crosscheck_node_index(matrix, destination_node_id);
+	signed char *edge;
+
+	if (i < 0 || j < 0)
+		return;
+
+	edge = &matrix->edge_status[i * matrix->node_count + j];
+
+	if (connection_status > *edge)
+		*edge = (signed char) connection_status;
 }
 
 
@@ -1424,23 +1511,72 @@ do_cluster_cleanup(void)
 
 	initPQExpBuffer(&event_details);
 
-	if (delete_monitoring_records(primary_conn, runtime_options.keep_history, runtime_options.node_id) == false)
+	/*
+	 * If the entire table is to be emptied, delete_monitoring_records() will
+	 * issue a TRUNCATE, which is cheap; otherwise delete the expired records
+	 * incrementally in bounded batches, pausing between batches, so the purge
+	 * doesn't generate one long burst of I/O and WAL.
+	 */
+	if (runtime_options.keep_history == 0 && runtime_options.node_id == UNKNOWN_NODE_ID)
 	{
-		appendPQExpBufferStr(&event_details,
-						  _("unable to delete monitoring records"));
+		if (delete_monitoring_records(primary_conn, runtime_options.keep_history, runtime_options.node_id) == false)
+		{
+			appendPQExpBufferStr(&event_details,
+							  _("unable to delete monitoring records"));
 
-		log_error("%s", event_details.data);
-		log_detail("%s", PQerrorMessage(primary_conn));
+			log_error("%s", event_details.data);
+			log_detail("%s", PQerrorMessage(primary_conn));
 
-		create_event_notification(primary_conn,
-								  &config_file_options,
-								  config_file_options.node_id,
-								  "cluster_cleanup",
-								  false,
-								  event_details.data);
+			create_event_notification(primary_conn,
+									  &config_file_options,
+									  config_file_options.node_id,
+									  "cluster_cleanup",
+									  false,
+									  event_details.data);
 
-		PQfinish(primary_conn);
-		exit(ERR_DB_QUERY);
+			PQfinish(primary_conn);
+			exit(ERR_DB_QUERY);
+		}
+	}
+	else
+	{
+		int			deleted = 0;
+		int			total_deleted = 0;
+
+		do
+		{
+			if (total_deleted > 0)
+				sleep(CLUSTER_CLEANUP_BATCH_PAUSE);
+
+			deleted = delete_monitoring_records_batch(primary_conn,
+													  runtime_options.keep_history,
+													  runtime_options.node_id,
+													  CLUSTER_CLEANUP_BATCH_SIZE);
+
+			if (deleted < 0)
+			{
+				appendPQExpBufferStr(&event_details,
+								  _("unable to delete monitoring records"));
+
+				log_error("%s", event_details.data);
+				log_detail("%s", PQerrorMessage(primary_conn));
+
+				create_event_notification(primary_conn,
+										  &config_file_options,
+										  config_file_options.node_id,
+										  "cluster_cleanup",
+										  false,
+										  event_details.data);
+
+				PQfinish(primary_conn);
+				exit(ERR_DB_QUERY);
+			}
+
+			total_deleted += deleted;
+
+			log_debug("%i monitoring records deleted (total: %i)",
+					  deleted, total_deleted);
+		} while (deleted >= CLUSTER_CLEANUP_BATCH_SIZE);
 	}
 
 	if (vacuum_table(primary_conn, "repmgr.monitoring_history") == false)
@@ -1512,6 +1648,7 @@ do_cluster_help(void)
 	printf(_("  Configuration file or database connection required.\n"));
 	puts("");
 	printf(_("    --csv                     emit output as CSV (with a subset of fields)\n"));
+	printf(_("    --output=json-lines       emit each node's record as a line of JSON, as soon as it is available\n"));
 	printf(_("    --compact                 display only a subset of fields\n"));
 	puts("");
 
@@ -1541,6 +1678,8 @@ do_cluster_help(void)
 	printf(_("    --limit                   maximum number of events to display (default: %i)\n"), CLUSTER_EVENT_LIMIT);
 	printf(_("    --all                     display all events (overrides --limit)\n"));
 	printf(_("    --event                   filter specific event\n"));
+	printf(_("    --since                   restrict to events logged at or after this timestamp\n"));
+	printf(_("    --until                   restrict to events logged at or before this timestamp\n"));
 	printf(_("    --node-id                 restrict entries to node with this ID\n"));
 	printf(_("    --node-name               restrict entries to node with this name\n"));
 	printf(_("    --compact                 omit \"Details\" column"));
@@ -34,12 +34,27 @@ typedef struct
 	t_node_status_rec **node_status_list;
 } t_node_matrix_rec;
 
+/*
+ * Aggregated "cluster crosscheck" connection state.
+ *
+ * Rather than materialising every (observer, origin, destination) probe
+ * result individually, one byte per directed node pair holds the maximum
+ * status any observing node reported for that pair (-2 = unknown,
+ * -1 = down, 0 = up); the aggregation is performed incrementally as each
+ * node's probe output is parsed.
+ */
 typedef struct
 {
 	int			node_id;
 	char		node_name[NAMEDATALEN];
-	t_node_matrix_rec **matrix_list_rec;
-} t_node_status_cube;
+} t_crosscheck_node;
+
+typedef struct
+{
+	int			node_count;
+	t_crosscheck_node *nodes;
+	signed char *edge_status;	/* node_count * node_count entries, row-major */
+} t_crosscheck_matrix;
 
 
 
@@ -20,6 +20,7 @@
  */
 
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <dirent.h>
 
 #include "repmgr.h"
@@ -32,10 +33,26 @@
 #include "repmgr-action-node.h"
 #include "repmgr-action-standby.h"
 
+/*
+ * Upper bound on the number of WAL segments prefetched by --prefetch-wal;
+ * anything beyond this will be fetched by "restore_command" during replay
+ * in the usual way.
+ */
+#define WAL_PREFETCH_MAX_SEGMENTS 2048
+
+/*
+ * Discard repmgrd's published lag trend statistics if they are older
+ * than this (repmgrd stopped, or node no longer a monitored standby).
+ */
+#define REPLICATION_LAG_STATS_MAX_AGE 60
+
 static bool copy_file(const char *src_file, const char *dest_file);
 static void format_archive_dir(PQExpBufferData *archive_dir);
 static t_server_action parse_server_action(const char *action);
 
+static void format_wal_prefetch_command(PQExpBufferData *buf, const char *restore_command, const char *xlogfname, const char *xlogpath);
+static pid_t start_wal_prefetch(PGconn *primary_conn);
+
 static void exit_optformat_error(const char *error, int errcode);
 
 static void _do_node_service_list_actions(t_server_action action);
@@ -47,11 +64,11 @@ static void do_node_check_replication_connection(void);
 static CheckStatus do_node_check_archive_ready(PGconn *conn, OutputMode mode, CheckStatusList *list_output);
 static CheckStatus do_node_check_downstream(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
 static CheckStatus do_node_check_upstream(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
-static CheckStatus do_node_check_replication_lag(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
+static CheckStatus do_node_check_replication_lag(PGconn *conn, OutputMode mode, t_node_info *node_info, t_node_check_snapshot *snapshot, CheckStatusList *list_output);
 static CheckStatus do_node_check_role(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
 static CheckStatus do_node_check_slots(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
 static CheckStatus do_node_check_missing_slots(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
-static CheckStatus do_node_check_data_directory(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
+static CheckStatus do_node_check_data_directory(PGconn *conn, OutputMode mode, t_node_info *node_info, t_node_check_snapshot *snapshot, CheckStatusList *list_output);
 static CheckStatus do_node_check_replication_config_owner(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output);
 static CheckStatus do_node_check_db_connection(PGconn *conn, OutputMode mode);
 
@@ -244,7 +261,9 @@ do_node_status(void)
 	{
 		int			ready_files;
 
-		ready_files = get_ready_archive_files(conn, data_dir);
+		ready_files = get_ready_archive_files(conn, data_dir,
+											  0, /* exact count wanted for display */
+											  config_file_options.archive_ready_cache_ttl);
 
 		if (ready_files == ARCHIVE_STATUS_DIR_ERROR)
 		{
@@ -612,6 +631,7 @@ _do_node_status_is_shutdown_cleanly(void)
 	PGPing		ping_status;
 	PQExpBufferData output;
 
+	ControlFileInfo *control_file_info = NULL;
 	DBState		db_state;
 	XLogRecPtr	checkPoint = InvalidXLogRecPtr;
 
@@ -647,18 +667,23 @@ _do_node_status_is_shutdown_cleanly(void)
 			break;
 	}
 
-	/* check what pg_control says */
+	/* check what pg_control says; one read serves all subsequent checks */
+
+	control_file_info = get_controlfile_snapshot(config_file_options.data_directory);
 
-	if (get_db_state(config_file_options.data_directory, &db_state) == false)
+	if (control_file_info->control_file_processed == false)
 	{
 		/*
 		 * Unable to retrieve the database state from pg_control
 		 */
 		node_status = NODE_STATUS_UNKNOWN;
 		log_verbose(LOG_DEBUG, "unable to determine db state");
+		pfree(control_file_info);
 		goto return_state;
 	}
 
+	db_state = control_file_info->state;
+
 	log_verbose(LOG_DEBUG, "db state now: %s", describe_db_state(db_state));
 
 	if (db_state != DB_SHUTDOWNED && db_state != DB_SHUTDOWNED_IN_RECOVERY)
@@ -674,7 +699,9 @@ _do_node_status_is_shutdown_cleanly(void)
 		}
 	}
 
-	checkPoint = get_latest_checkpoint_location(config_file_options.data_directory);
+	checkPoint = control_file_info->checkPoint;
+
+	pfree(control_file_info);
 
 	if (checkPoint == InvalidXLogRecPtr)
 	{
@@ -741,6 +768,7 @@ do_node_check(void)
 	PQExpBufferData output;
 
 	t_node_info node_info = T_NODE_INFO_INITIALIZER;
+	t_node_check_snapshot node_check_snapshot = T_NODE_CHECK_SNAPSHOT_INITIALIZER;
 
 	CheckStatus return_code;
 	CheckStatusList status_list = {NULL, NULL};
@@ -859,6 +887,46 @@ do_node_check(void)
 	/* add replication statistics to node record */
 	get_node_replication_stats(conn, &node_info);
 
+	/*
+	 * --switchover-preflight option: for use by "standby switchover", which
+	 * executes this on the demotion candidate to gather all the facts needed
+	 * by its preliminary checks in a single remote invocation, rather than
+	 * one SSH round trip per check. The combined output is consumed by the
+	 * individual option parsers on the invoking node.
+	 */
+	if (runtime_options.switchover_preflight == true)
+	{
+		if (runtime_options.output_mode != OM_OPTFORMAT)
+		{
+			log_error(_("--switchover-preflight option can only be used with --optformat"));
+			PQfinish(conn);
+			exit(ERR_BAD_CONFIG);
+		}
+
+		(void) do_node_check_data_directory(conn,
+											OM_OPTFORMAT,
+											&node_info,
+											NULL,
+											NULL);
+
+		/* "postgresql.auto.conf" ownership is only relevant on PostgreSQL 12 and later */
+		if (PQserverVersion(conn) >= 120000)
+			(void) do_node_check_replication_config_owner(conn,
+														  OM_OPTFORMAT,
+														  &node_info,
+														  NULL);
+
+		(void) do_node_check_archive_ready(conn,
+										   OM_OPTFORMAT,
+										   NULL);
+
+		if (runtime_options.remote_node_id != UNKNOWN_NODE_ID)
+			do_node_check_replication_connection();
+
+		PQfinish(conn);
+		exit(SUCCESS);
+	}
+
 	/*
 	 * handle specific checks ======================
 	 */
@@ -896,6 +964,7 @@ do_node_check(void)
 		return_code = do_node_check_replication_lag(conn,
 													runtime_options.output_mode,
 													&node_info,
+													NULL,
 													NULL);
 		PQfinish(conn);
 		exit(return_code);
@@ -936,6 +1005,7 @@ do_node_check(void)
 		return_code = do_node_check_data_directory(conn,
 												   runtime_options.output_mode,
 												   &node_info,
+												   NULL,
 												   NULL);
 		PQfinish(conn);
 		exit(return_code);
@@ -964,11 +1034,18 @@ do_node_check(void)
 
 	initPQExpBuffer(&output);
 
+	/*
+	 * Prefetch the results of the various per-check queries in a single
+	 * batched round trip; if this fails, the individual checks will fall
+	 * back to executing their queries one-by-one.
+	 */
+	(void) get_node_check_snapshot(conn, &node_check_snapshot);
+
 	/* order functions are called is also output order */
 	if (do_node_check_role(conn, runtime_options.output_mode, &node_info, &status_list) != CHECK_STATUS_OK)
 		issue_detected = true;
 
-	if (do_node_check_replication_lag(conn, runtime_options.output_mode, &node_info, &status_list) != CHECK_STATUS_OK)
+	if (do_node_check_replication_lag(conn, runtime_options.output_mode, &node_info, &node_check_snapshot, &status_list) != CHECK_STATUS_OK)
 		issue_detected = true;
 
 	if (do_node_check_archive_ready(conn, runtime_options.output_mode, &status_list) != CHECK_STATUS_OK)
@@ -986,7 +1063,7 @@ do_node_check(void)
 	if (do_node_check_missing_slots(conn, runtime_options.output_mode, &node_info, &status_list) != CHECK_STATUS_OK)
 		issue_detected = true;
 
-	if (do_node_check_data_directory(conn, runtime_options.output_mode, &node_info, &status_list) != CHECK_STATUS_OK)
+	if (do_node_check_data_directory(conn, runtime_options.output_mode, &node_info, &node_check_snapshot, &status_list) != CHECK_STATUS_OK)
 		issue_detected = true;
 
 	if (runtime_options.output_mode == OM_CSV)
@@ -1134,7 +1211,13 @@ do_node_check_archive_ready(PGconn *conn, OutputMode mode, CheckStatusList *list
 
 	initPQExpBuffer(&details);
 
-	ready_archive_files = get_ready_archive_files(conn, config_file_options.data_directory);
+	/*
+	 * Only the threshold band matters here, so the directory scan can stop
+	 * once the critical threshold has been exceeded.
+	 */
+	ready_archive_files = get_ready_archive_files(conn, config_file_options.data_directory,
+												  config_file_options.archive_ready_critical + 1,
+												  config_file_options.archive_ready_cache_ttl);
 
 	if (ready_archive_files > config_file_options.archive_ready_critical)
 	{
@@ -1551,7 +1634,7 @@ do_node_check_upstream(PGconn *conn, OutputMode mode, t_node_info *node_info, Ch
 
 
 static CheckStatus
-do_node_check_replication_lag(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output)
+do_node_check_replication_lag(PGconn *conn, OutputMode mode, t_node_info *node_info, t_node_check_snapshot *snapshot, CheckStatusList *list_output)
 {
 	CheckStatus status = CHECK_STATUS_OK;
 	int			lag_seconds = 0;
@@ -1598,7 +1681,10 @@ do_node_check_replication_lag(PGconn *conn, OutputMode mode, t_node_info *node_i
 	}
 	else
 	{
-		lag_seconds = get_replication_lag_seconds(conn);
+		if (snapshot != NULL && snapshot->prefetched == true)
+			lag_seconds = snapshot->replication_lag_seconds;
+		else
+			lag_seconds = get_replication_lag_seconds(conn);
 
 		log_debug("lag seconds: %i", lag_seconds);
 
@@ -1707,6 +1793,57 @@ do_node_check_replication_lag(PGconn *conn, OutputMode mode, t_node_info *node_i
 					break;
 			}
 		}
+
+		/*
+		 * If a running repmgrd has published lag trend statistics for this
+		 * node, append the derived apply rate and catch-up estimate. These
+		 * are only included in the human-readable output; threshold
+		 * evaluation above is unaffected.
+		 */
+		if (mode == OM_TEXT && status != CHECK_STATUS_UNKNOWN)
+		{
+			PQExpBufferData lag_stats;
+			long		updated = 0;
+			long		window_seconds = 0;
+			int			samples = 0;
+			long long	receive_rate = 0;
+			long long	apply_rate = 0;
+			long long	lag_bytes = 0;
+			long long	catchup_seconds = 0;
+
+			initPQExpBuffer(&lag_stats);
+
+			if (repmgrd_get_lag_stats(conn, &lag_stats) == true
+				&& sscanf(lag_stats.data,
+						  "updated=%li window_seconds=%li samples=%i receive_rate=%lld apply_rate=%lld lag_bytes=%lld estimated_catchup_seconds=%lld",
+						  &updated, &window_seconds, &samples,
+						  &receive_rate, &apply_rate, &lag_bytes,
+						  &catchup_seconds) == 7
+				&& ((long) time(NULL) - updated) <= REPLICATION_LAG_STATS_MAX_AGE)
+			{
+				appendPQExpBuffer(&details,
+								  _("; apply rate over last %li seconds: %lld bytes/sec"),
+								  window_seconds,
+								  apply_rate);
+
+				if (lag_bytes > 0)
+				{
+					if (catchup_seconds >= 0)
+					{
+						appendPQExpBuffer(&details,
+										  _(", estimated catch-up time: %lld seconds"),
+										  catchup_seconds);
+					}
+					else
+					{
+						appendPQExpBufferStr(&details,
+											 _(", not catching up at current rates"));
+					}
+				}
+			}
+
+			termPQExpBuffer(&lag_stats);
+		}
 	}
 
 	switch (mode)
@@ -1752,7 +1889,9 @@ do_node_check_role(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckS
 
 	CheckStatus status = CHECK_STATUS_OK;
 	PQExpBufferData details;
-	RecoveryType recovery_type = get_recovery_type(conn);
+
+	/* normally already cached by get_node_replication_stats() */
+	RecoveryType recovery_type = node_info->recovery_type;
 
 	if (mode == OM_CSV && list_output == NULL)
 	{
@@ -1761,6 +1900,9 @@ do_node_check_role(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckS
 		exit(ERR_BAD_CONFIG);
 	}
 
+	if (recovery_type == RECTYPE_UNKNOWN)
+		recovery_type = get_recovery_type(conn);
+
 	initPQExpBuffer(&details);
 
 	switch (node_info->type)
@@ -2025,10 +2167,12 @@ do_node_check_missing_slots(PGconn *conn, OutputMode mode, t_node_info *node_inf
 
 
 CheckStatus
-do_node_check_data_directory(PGconn *conn, OutputMode mode, t_node_info *node_info, CheckStatusList *list_output)
+do_node_check_data_directory(PGconn *conn, OutputMode mode, t_node_info *node_info, t_node_check_snapshot *snapshot, CheckStatusList *list_output)
 {
 	CheckStatus status = CHECK_STATUS_OK;
 	char actual_data_directory[MAXPGPATH] = "";
+	bool		has_settings_role;
+	bool		data_directory_retrieved;
 	PQExpBufferData details;
 
 	if (mode == OM_CSV && list_output == NULL)
@@ -2040,14 +2184,30 @@ do_node_check_data_directory(PGconn *conn, OutputMode mode, t_node_info *node_in
 
 	initPQExpBuffer(&details);
 
+	if (snapshot != NULL && snapshot->prefetched == true)
+		has_settings_role = snapshot->has_read_all_settings_role;
+	else
+		has_settings_role = connection_has_pg_monitor_role(conn, "pg_read_all_settings");
+
 	/*
 	 * Check actual data directory matches that in repmgr.conf; note this requires
 	 * a superuser connection
 	 */
-	if (connection_has_pg_monitor_role(conn, "pg_read_all_settings") == true)
+	if (has_settings_role == true)
 	{
-		/* we expect to have a database connection */
-		if (get_pg_setting(conn, "data_directory", actual_data_directory) == false)
+		if (snapshot != NULL && snapshot->prefetched == true)
+		{
+			snprintf(actual_data_directory, MAXPGPATH,
+					 "%s", snapshot->data_directory);
+			data_directory_retrieved = actual_data_directory[0] != '\0';
+		}
+		else
+		{
+			/* we expect to have a database connection */
+			data_directory_retrieved = get_pg_setting(conn, "data_directory", actual_data_directory);
+		}
+
+		if (data_directory_retrieved == false)
 		{
 			appendPQExpBuffer(&details,
 							  _("unable to determine current \"data_directory\""));
@@ -2468,6 +2628,208 @@ parse_server_action(const char *action_name)
 }
 
 
+/*
+ * Build a shell command from a "restore_command" template, substituting
+ * the %f, %p, %r and %% placeholders in the same way as the backend.
+ *
+ * We don't track restartpoints, so for %r the fetched file itself is
+ * provided as the most conservative possible value.
+ */
+static void
+format_wal_prefetch_command(PQExpBufferData *buf, const char *restore_command, const char *xlogfname, const char *xlogpath)
+{
+	const char *ptr;
+
+	for (ptr = restore_command; *ptr != '\0'; ptr++)
+	{
+		if (ptr[0] == '%')
+		{
+			switch (ptr[1])
+			{
+				case 'f':
+					appendPQExpBufferStr(buf, xlogfname);
+					ptr++;
+					continue;
+				case 'p':
+					appendPQExpBufferStr(buf, xlogpath);
+					ptr++;
+					continue;
+				case 'r':
+					appendPQExpBufferStr(buf, xlogfname);
+					ptr++;
+					continue;
+				case '%':
+					appendPQExpBufferChar(buf, '%');
+					ptr++;
+					continue;
+				default:
+					break;
+			}
+		}
+
+		appendPQExpBufferChar(buf, *ptr);
+	}
+}
+
+
+/*
+ * Prefetch the WAL segments the node will need to replay after rejoining,
+ * from the local node's latest checkpoint location up to the primary's
+ * current LSN, using the "restore_command" defined in repmgr.conf.
+ *
+ * The downloads execute in parallel in a forked child process, so the
+ * network I/O can be overlapped with pg_rewind's local work; the caller
+ * must wait for the returned pid before restarting the node.
+ *
+ * Segments are fetched to a temporary file name and renamed into place,
+ * so a partial download can never be mistaken for a complete segment.
+ *
+ * Returns the pid of the prefetching process, or -1 if the prefetch
+ * could not be started; this is not fatal, as replay will fall back to
+ * fetching segments one-by-one via "restore_command" as usual.
+ */
+static pid_t
+start_wal_prefetch(PGconn *primary_conn)
+{
+	XLogRecPtr	start_lsn = InvalidXLogRecPtr;
+	XLogRecPtr	end_lsn = InvalidXLogRecPtr;
+	TimeLineID	tli = UNKNOWN_TIMELINE_ID;
+	uint32		wal_segment_size = 0;
+	uint64		segs_per_id;
+	uint64		start_segno;
+	uint64		end_segno;
+	uint64		segment_count;
+	const char *wal_dir = NULL;
+	pid_t		prefetch_pid;
+
+	start_lsn = get_latest_checkpoint_location(config_file_options.data_directory);
+	end_lsn = get_primary_current_lsn(primary_conn);
+	tli = get_node_timeline(primary_conn, NULL);
+	wal_segment_size = get_wal_segment_size(config_file_options.data_directory);
+
+	if (start_lsn == InvalidXLogRecPtr || end_lsn == InvalidXLogRecPtr ||
+		tli == UNKNOWN_TIMELINE_ID || wal_segment_size == 0)
+	{
+		log_warning(_("unable to determine the WAL range to prefetch"));
+		log_detail(_("WAL segments will be fetched by \"restore_command\" during replay"));
+		return -1;
+	}
+
+	wal_dir = get_pg_version(config_file_options.data_directory, NULL) >= 100000
+		? "pg_wal"
+		: "pg_xlog";
+
+	segs_per_id = UINT64CONST(0x100000000) / wal_segment_size;
+
+	start_segno = start_lsn / wal_segment_size;
+	end_segno = end_lsn / wal_segment_size;
+
+	segment_count = (end_segno - start_segno) + 1;
+
+	/*
+	 * Prefetch the oldest segments, which replay will need first; any
+	 * remainder will be fetched by "restore_command" in the usual way.
+	 */
+	if (segment_count > WAL_PREFETCH_MAX_SEGMENTS)
+		segment_count = WAL_PREFETCH_MAX_SEGMENTS;
+
+	log_notice(_("prefetching %lu WAL segments on timeline %i in the background"),
+			   (unsigned long) segment_count,
+			   (int) tli);
+
+	prefetch_pid = fork();
+
+	switch (prefetch_pid)
+	{
+		case -1:
+			log_warning(_("unable to fork WAL prefetch process"));
+			log_detail("%s", strerror(errno));
+			break;
+
+		case 0:
+		{
+			/* prefetch process */
+			t_parallel_command *fetch_commands;
+			int			fetch_command_count = 0;
+			uint64		segno;
+			int			i;
+
+			fetch_commands = pg_malloc0(sizeof(t_parallel_command) * segment_count);
+
+			for (segno = start_segno; segno < start_segno + segment_count; segno++)
+			{
+				char		xlogfname[MAXLEN] = "";
+				char		xlogpath[MAXPGPATH] = "";
+				char		tmppath[MAXPGPATH + 16] = "";
+				struct stat statbuf;
+				t_parallel_command *fetch_command;
+
+				snprintf(xlogfname, MAXLEN,
+						 "%08X%08X%08X",
+						 (uint32) tli,
+						 (uint32) (segno / segs_per_id),
+						 (uint32) (segno % segs_per_id));
+
+				snprintf(xlogpath, MAXPGPATH,
+						 "%s/%s/%s",
+						 config_file_options.data_directory,
+						 wal_dir,
+						 xlogfname);
+
+				/* skip segments already present locally */
+				if (stat(xlogpath, &statbuf) == 0)
+					continue;
+
+				snprintf(tmppath, sizeof(tmppath),
+						 "%s.prefetch",
+						 xlogpath);
+
+				fetch_command = &fetch_commands[fetch_command_count++];
+
+				fetch_command->id = (int) (segno - start_segno);
+				initPQExpBuffer(&fetch_command->command);
+				initPQExpBuffer(&fetch_command->output);
+
+				format_wal_prefetch_command(&fetch_command->command,
+											config_file_options.restore_command,
+											xlogfname,
+											tmppath);
+
+				appendPQExpBufferStr(&fetch_command->command, " && mv ");
+				appendShellString(&fetch_command->command, tmppath);
+				appendPQExpBufferChar(&fetch_command->command, ' ');
+				appendShellString(&fetch_command->command, xlogpath);
+				appendPQExpBufferStr(&fetch_command->command, " || rm -f ");
+				appendShellString(&fetch_command->command, tmppath);
+			}
+
+			if (fetch_command_count > 0)
+				(void) execute_parallel_commands(fetch_commands,
+												 fetch_command_count,
+												 PARALLEL_COMMAND_MAX_WORKERS);
+
+			for (i = 0; i < fetch_command_count; i++)
+			{
+				termPQExpBuffer(&fetch_commands[i].command);
+				termPQExpBuffer(&fetch_commands[i].output);
+			}
+
+			pg_free(fetch_commands);
+
+			/*
+			 * _exit() here as the inherited database connections belong
+			 * to the parent process
+			 */
+			_exit(0);
+		}
+
+		default:
+			break;
+	}
+
+	return prefetch_pid;
+}
+
 
 /*
  * Rejoin a dormant (shut down) node to the replication cluster; this
@@ -2481,6 +2843,7 @@ parse_server_action(const char *action_name)
  *   --force-rewind[=VALUE]
  *   --config-files
  *   --config-archive-dir
+ *   --prefetch-wal
  *   -W/--no-wait
  */
 void
@@ -2490,6 +2853,7 @@ do_node_rejoin(void)
 	RecoveryType primary_recovery_type = RECTYPE_UNKNOWN;
 	PGconn	   *primary_conn = NULL;
 
+	ControlFileInfo *control_file_info = NULL;
 	DBState		db_state;
 	PGPing		status;
 	bool		is_shutdown = true;
@@ -2501,6 +2865,8 @@ do_node_rejoin(void)
 	t_node_info primary_node_record = T_NODE_INFO_INITIALIZER;
 	t_node_info local_node_record = T_NODE_INFO_INITIALIZER;
 
+	pid_t		prefetch_pid = -1;
+
 	bool		success = true;
 	int			follow_error_code = SUCCESS;
 
@@ -2523,12 +2889,20 @@ do_node_rejoin(void)
 			break;
 	}
 
-	if (get_db_state(config_file_options.data_directory, &db_state) == false)
+	/*
+	 * Read pg_control once; all control file values needed during the
+	 * rejoin are served from this snapshot.
+	 */
+	control_file_info = get_controlfile_snapshot(config_file_options.data_directory);
+
+	if (control_file_info->control_file_processed == false)
 	{
 		log_error(_("unable to determine database state from pg_control"));
 		exit(ERR_BAD_CONFIG);
 	}
 
+	db_state = control_file_info->state;
+
 	if (is_shutdown == false)
 	{
 		log_error(_("database is still running in state \"%s\""),
@@ -2645,8 +3019,8 @@ do_node_rejoin(void)
 	 */
 	{
 		bool can_follow;
-		TimeLineID tli = get_min_recovery_end_timeline(config_file_options.data_directory);
-		XLogRecPtr min_recovery_location = get_min_recovery_location(config_file_options.data_directory);
+		TimeLineID tli = control_file_info->minRecoveryPointTLI;
+		XLogRecPtr min_recovery_location = control_file_info->minRecoveryPoint;
 
 		/*
 		 * It's possible this was a former primary, so the minRecoveryPoint*
@@ -2654,9 +3028,9 @@ do_node_rejoin(void)
 		 */
 
 		if (min_recovery_location == InvalidXLogRecPtr)
-			min_recovery_location = get_latest_checkpoint_location(config_file_options.data_directory);
+			min_recovery_location = control_file_info->checkPoint;
 		if (tli == 0)
-			tli = get_timeline(config_file_options.data_directory);
+			tli = control_file_info->timeline;
 
 		can_follow = check_node_can_attach(tli,
 										   min_recovery_location,
@@ -2671,6 +3045,34 @@ do_node_rejoin(void)
 		}
 	}
 
+	pfree(control_file_info);
+	control_file_info = NULL;
+
+
+	/*
+	 * --prefetch-wal specified - start fetching the WAL segments the node
+	 * will need to replay into the local WAL directory with parallel
+	 * downloads, overlapping the network I/O with any pg_rewind execution.
+	 */
+
+	if (runtime_options.prefetch_wal == true)
+	{
+		if (config_file_options.restore_command[0] == '\0')
+		{
+			log_error(_("--prefetch-wal requires \"restore_command\" to be set in \"repmgr.conf\""));
+			PQfinish(primary_conn);
+			exit(ERR_BAD_CONFIG);
+		}
+
+		if (runtime_options.dry_run == true)
+		{
+			log_info(_("WAL segments required for replay would be prefetched using \"restore_command\""));
+		}
+		else
+		{
+			prefetch_pid = start_wal_prefetch(primary_conn);
+		}
+	}
 
 	/*
 	 * --force-rewind specified - check prerequisites, and attempt to execute
@@ -2873,6 +3275,25 @@ do_node_rejoin(void)
 		exit(SUCCESS);
 	}
 
+	/*
+	 * Wait for any background WAL prefetch to complete before restarting
+	 * the node, so the prefetched segments are all in place when replay
+	 * begins.
+	 */
+	if (prefetch_pid > 0)
+	{
+		int			stat_loc;
+
+		log_info(_("waiting for background WAL prefetch (pid %i) to complete"),
+				 (int) prefetch_pid);
+
+		if (waitpid(prefetch_pid, &stat_loc, 0) < 0)
+		{
+			log_warning(_("unable to wait for WAL prefetch process"));
+			log_detail("%s", strerror(errno));
+		}
+	}
+
 	initPQExpBuffer(&follow_output);
 
 	/*
@@ -3545,6 +3966,8 @@ do_node_help(void)
 			 "                            after executing \"pg_rewind\"\n"));
 	printf(_("    --config-archive-dir    directory to temporarily store retained configuration files\n" \
 			 "                              (default: /tmp)\n"));
+	printf(_("    --prefetch-wal          prefetch WAL segments required for replay in parallel\n" \
+			 "                              using \"restore_command\" from \"repmgr.conf\"\n"));
 	printf(_("    -W, --no-wait           don't wait for the node to rejoin cluster\n"));
 	puts("");
 
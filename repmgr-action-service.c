@@ -68,6 +68,9 @@ do_service_status(void)
 	RepmgrdInfo **repmgrd_info;
 	ItemList	warnings = {NULL, NULL};
 	bool		connection_error_found = false;
+	PQExpBufferData timings_output;
+
+	initPQExpBuffer(&timings_output);
 
 	/* Connect to local database to obtain cluster connection data */
 	log_verbose(LOG_INFO, _("connecting to database"));
@@ -226,6 +229,24 @@ do_service_status(void)
 					maxlen_snprintf(repmgrd_info[i]->upstream_last_seen_text, _("%i second(s) ago"), repmgrd_info[i]->upstream_last_seen);
 				}
 			}
+
+			if (runtime_options.timings == true && repmgrd_info[i]->running == true)
+			{
+				PQExpBufferData timings;
+
+				initPQExpBuffer(&timings);
+
+				if (repmgrd_get_timings(cell->node_info->conn, &timings) == true)
+				{
+					appendPQExpBuffer(&timings_output,
+									  _("\nnode \"%s\" (ID: %i) phase timings:\n%s\n"),
+									  cell->node_info->node_name,
+									  cell->node_info->node_id,
+									  timings.data);
+				}
+
+				termPQExpBuffer(&timings);
+			}
 		}
 
 		initPQExpBuffer(&node_status);
@@ -351,6 +372,21 @@ do_service_status(void)
 
 	pfree(repmgrd_info);
 
+	if (runtime_options.timings == true && runtime_options.output_mode == OM_TEXT)
+	{
+		if (timings_output.data[0] != '\0')
+		{
+			printf("%s", timings_output.data);
+		}
+		else
+		{
+			puts("");
+			log_info(_("no repmgrd phase timings available"));
+		}
+	}
+
+	termPQExpBuffer(&timings_output);
+
 	/* emit any warnings */
 
 	if (warnings.head != NULL && runtime_options.terse == false && runtime_options.output_mode != OM_CSV)
@@ -525,6 +561,7 @@ void do_service_help(void)
 	puts("");
 	printf(_("    --csv                     emit output as CSV\n"));
 	printf(_("    --detail                  show additional detail\n"));
+	printf(_("    --timings                 show repmgrd phase timing histograms\n"));
 	printf(_("    --verbose                 show text of database connection error messages\n"));
 	puts("");
 
@@ -29,6 +29,8 @@
 #include "repmgr-client-global.h"
 #include "repmgr-action-standby.h"
 
+/* maximum number of concurrent Barman transfer workers (see run_file_backup()) */
+#define BARMAN_TRANSFER_MAX_WORKERS 4
 
 typedef struct TablespaceDataListCell
 {
@@ -3569,6 +3571,10 @@ do_standby_switchover(void)
 	PQExpBufferData errmsg;
 	PQExpBufferData detailmsg;
 
+	/* combined output of the batched remote preliminary checks */
+	PQExpBufferData preflight_output;
+	bool		preflight_valid = false;
+
 	int			r,
 				i;
 	bool		command_success = false;
@@ -3961,6 +3967,15 @@ do_standby_switchover(void)
 		termPQExpBuffer(&msg);
 	}
 
+	/*
+	 * Establish a multiplexed SSH session to the demotion candidate; the
+	 * many remote commands executed during the switchover will then reuse
+	 * one SSH connection rather than each performing a full handshake.
+	 */
+	ssh_session_begin(remote_host,
+					  runtime_options.remote_user,
+					  config_file_options.ssh_options);
+
 	/* check remote repmgr binary can be found */
 	initPQExpBuffer(&remote_command_str);
 	make_remote_repmgr_path(&remote_command_str, &remote_node_record);
@@ -4105,6 +4120,56 @@ do_standby_switchover(void)
 	}
 
 
+	/*
+	 * Where the remote repmgr is recent enough, interrogate the demotion
+	 * candidate with a single batched "node check --switchover-preflight"
+	 * invocation; its output contains the facts required by the following
+	 * preliminary checks, whose parsers each extract their own values,
+	 * saving one SSH round trip per check. With an older remote repmgr,
+	 * each check will execute its own remote command as before.
+	 */
+
+	initPQExpBuffer(&preflight_output);
+
+	if (remote_repmgr_version >= 50200)
+	{
+		initPQExpBuffer(&remote_command_str);
+		make_remote_repmgr_path(&remote_command_str, &remote_node_record);
+
+		appendPQExpBuffer(&remote_command_str,
+						  "node check --switchover-preflight --remote-node-id=%i --optformat -LINFO 2>/dev/null",
+						  local_node_record.node_id);
+
+		command_success = remote_command(remote_host,
+										 runtime_options.remote_user,
+										 remote_command_str.data,
+										 config_file_options.ssh_options,
+										 &preflight_output);
+
+		termPQExpBuffer(&remote_command_str);
+
+		if (command_success == true && preflight_output.data[0] != '\0')
+		{
+			char *ptr;
+
+			/*
+			 * The payload contains one line per check; flatten it so the
+			 * option parsers (which tokenise on spaces) can consume it.
+			 */
+			for (ptr = preflight_output.data; *ptr; ptr++)
+			{
+				if (*ptr == '\n' || *ptr == '\r')
+					*ptr = ' ';
+			}
+
+			preflight_valid = true;
+		}
+		else
+		{
+			log_debug("unable to execute batched switchover preflight check, falling back to individual checks");
+		}
+	}
+
 	/*
 	 * Sanity-check remote "data_directory" is correctly configured in repmgr.conf.
 	 *
@@ -4112,24 +4177,33 @@ do_standby_switchover(void)
 	 * directory after the remote (demotion candidate) has shut down.
 	 */
 
-	initPQExpBuffer(&remote_command_str);
-	make_remote_repmgr_path(&remote_command_str, &remote_node_record);
+	initPQExpBuffer(&command_output);
 
-	/*
-	 * --data-directory-config is available from repmgr 4.3; it will fail
-	 * if the remote repmgr is an earlier version, but the version should match
-	 * anyway.
-	 */
-	appendPQExpBufferStr(&remote_command_str, "node check --data-directory-config --optformat -LINFO 2>/dev/null");
+	if (preflight_valid == true)
+	{
+		command_success = true;
+		appendPQExpBufferStr(&command_output, preflight_output.data);
+	}
+	else
+	{
+		initPQExpBuffer(&remote_command_str);
+		make_remote_repmgr_path(&remote_command_str, &remote_node_record);
 
-	initPQExpBuffer(&command_output);
-	command_success = remote_command(remote_host,
-									 runtime_options.remote_user,
-									 remote_command_str.data,
-									 config_file_options.ssh_options,
-									 &command_output);
+		/*
+		 * --data-directory-config is available from repmgr 4.3; it will fail
+		 * if the remote repmgr is an earlier version, but the version should match
+		 * anyway.
+		 */
+		appendPQExpBufferStr(&remote_command_str, "node check --data-directory-config --optformat -LINFO 2>/dev/null");
 
-	termPQExpBuffer(&remote_command_str);
+		command_success = remote_command(remote_host,
+										 runtime_options.remote_user,
+										 remote_command_str.data,
+										 config_file_options.ssh_options,
+										 &command_output);
+
+		termPQExpBuffer(&remote_command_str);
+	}
 
 	if (command_success == false)
 	{
@@ -4318,19 +4392,28 @@ do_standby_switchover(void)
 
 	if (PQserverVersion(local_conn) >= 120000 && remote_repmgr_version >= 50100)
 	{
-		initPQExpBuffer(&remote_command_str);
-		make_remote_repmgr_path(&remote_command_str, &remote_node_record);
+		initPQExpBuffer(&command_output);
+
+		if (preflight_valid == true)
+		{
+			command_success = true;
+			appendPQExpBufferStr(&command_output, preflight_output.data);
+		}
+		else
+		{
+			initPQExpBuffer(&remote_command_str);
+			make_remote_repmgr_path(&remote_command_str, &remote_node_record);
 
-		appendPQExpBufferStr(&remote_command_str, "node check --replication-config-owner --optformat -LINFO 2>/dev/null");
+			appendPQExpBufferStr(&remote_command_str, "node check --replication-config-owner --optformat -LINFO 2>/dev/null");
 
-		initPQExpBuffer(&command_output);
-		command_success = remote_command(remote_host,
-										 runtime_options.remote_user,
-										 remote_command_str.data,
-										 config_file_options.ssh_options,
-										 &command_output);
+			command_success = remote_command(remote_host,
+											 runtime_options.remote_user,
+											 remote_command_str.data,
+											 config_file_options.ssh_options,
+											 &command_output);
 
-		termPQExpBuffer(&remote_command_str);
+			termPQExpBuffer(&remote_command_str);
+		}
 
 		if (command_success == false)
 		{
@@ -4412,21 +4495,29 @@ do_standby_switchover(void)
 
 	/* check demotion candidate can make replication connection to promotion candidate */
 	{
-		initPQExpBuffer(&remote_command_str);
-		make_remote_repmgr_path(&remote_command_str, &remote_node_record);
-		appendPQExpBuffer(&remote_command_str,
-						  "node check --remote-node-id=%i --replication-connection",
-						  local_node_record.node_id);
-
 		initPQExpBuffer(&command_output);
 
-		command_success = remote_command(remote_host,
-										 runtime_options.remote_user,
-										 remote_command_str.data,
-										 config_file_options.ssh_options,
-										 &command_output);
+		if (preflight_valid == true)
+		{
+			command_success = true;
+			appendPQExpBufferStr(&command_output, preflight_output.data);
+		}
+		else
+		{
+			initPQExpBuffer(&remote_command_str);
+			make_remote_repmgr_path(&remote_command_str, &remote_node_record);
+			appendPQExpBuffer(&remote_command_str,
+							  "node check --remote-node-id=%i --replication-connection",
+							  local_node_record.node_id);
 
-		termPQExpBuffer(&remote_command_str);
+			command_success = remote_command(remote_host,
+											 runtime_options.remote_user,
+											 remote_command_str.data,
+											 config_file_options.ssh_options,
+											 &command_output);
+
+			termPQExpBuffer(&remote_command_str);
+		}
 
 		if (command_success == true)
 		{
@@ -4467,20 +4558,28 @@ do_standby_switchover(void)
 			int			threshold = 0;
 			t_remote_error_type remote_error = REMOTE_ERROR_NONE;
 
-			initPQExpBuffer(&remote_command_str);
-			make_remote_repmgr_path(&remote_command_str, &remote_node_record);
-			appendPQExpBufferStr(&remote_command_str,
-								 "node check --terse -LERROR --archive-ready --optformat");
-
 			initPQExpBuffer(&command_output);
 
-			command_success = remote_command(remote_host,
-											 runtime_options.remote_user,
-											 remote_command_str.data,
-											 config_file_options.ssh_options,
-											 &command_output);
-
-			termPQExpBuffer(&remote_command_str);
+			if (preflight_valid == true)
+			{
+				command_success = true;
+				appendPQExpBufferStr(&command_output, preflight_output.data);
+			}
+			else
+			{
+				initPQExpBuffer(&remote_command_str);
+				make_remote_repmgr_path(&remote_command_str, &remote_node_record);
+				appendPQExpBufferStr(&remote_command_str,
+									 "node check --terse -LERROR --archive-ready --optformat");
+
+				command_success = remote_command(remote_host,
+												 runtime_options.remote_user,
+												 remote_command_str.data,
+												 config_file_options.ssh_options,
+												 &command_output);
+
+				termPQExpBuffer(&remote_command_str);
+			}
 
 			if (command_success == true)
 			{
@@ -4660,6 +4759,9 @@ do_standby_switchover(void)
 		}
 	}
 
+	/* all preliminary remote checks completed */
+	termPQExpBuffer(&preflight_output);
+
 	PQfinish(remote_conn);
 
 	/*
@@ -4965,6 +5067,8 @@ do_standby_switchover(void)
 
 		key_value_list_free(&remote_config_files);
 
+		ssh_session_end_all();
+
 		if (dry_run_success == false)
 		{
 			log_error(_("prerequisites for executing STANDBY SWITCHOVER are *not* met"));
@@ -5529,6 +5633,8 @@ do_standby_switchover(void)
 		clear_node_info_list(&all_nodes);
 	}
 
+	ssh_session_end_all();
+
 	if (switchover_success == true)
 	{
 		log_notice(_("STANDBY SWITCHOVER has completed successfully"));
@@ -6617,6 +6723,14 @@ run_basebackup(t_node_info *node_record)
 	TablespaceListCell *cell = NULL;
 	t_basebackup_options backup_options = T_BASEBACKUP_OPTIONS_INITIALIZER;
 
+	FILE	   *backup_fp = NULL;
+	char		backup_output[MAXLEN];
+	t_node_info upstream_node_record = T_NODE_INFO_INITIALIZER;
+	t_replication_slot slot_info = T_REPLICATION_SLOT_INITIALIZER;
+	bool		slot_exists_on_upstream = false;
+	bool		upstream_slot_error = false;
+	PQExpBufferData slot_error_details;
+
 	/*
 	 * Parse the pg_basebackup_options provided in repmgr.conf - we'll want to
 	 * check later whether certain options were set by the user
@@ -6777,34 +6891,37 @@ run_basebackup(t_node_info *node_record)
 	log_info(_("executing:\n  %s"), script.data);
 
 	/*
-	 * As of 9.4, pg_basebackup only ever returns 0 or 1
+	 * Execute pg_basebackup via popen() rather than system(), so that
+	 * independent setup steps can be overlapped with the data transfer.
+	 * pg_basebackup writes its progress output to stderr, which remains
+	 * attached to the terminal.
 	 */
+	backup_fp = popen(script.data, "r");
 
-	r = system(script.data);
-
-	termPQExpBuffer(&script);
-
-	if (r != 0)
+	if (backup_fp == NULL)
+	{
+		log_error(_("unable to execute:\n  %s"), script.data);
+		termPQExpBuffer(&script);
 		return ERR_BAD_BASEBACKUP;
+	}
 
-	/* check connections are still available */
-	(void)connection_ping_reconnect(primary_conn);
-
-	if (source_conn != primary_conn)
-		(void)connection_ping_reconnect(source_conn);
+	initPQExpBuffer(&slot_error_details);
 
 	/*
 	 * If replication slots in use, check the created slot is on the correct
-	 * node; the slot will initially get created on the source node, and will
-	 * need to be dropped and recreated on the actual upstream node if these
-	 * differ.
+	 * node while the base backup is streaming; the slot will initially get
+	 * created on the source node, and will need to be dropped and recreated
+	 * on the actual upstream node if these differ.
+	 *
+	 * Performing the upstream slot setup during the transfer both hides the
+	 * network round trips and starts WAL retention on the designated
+	 * upstream as early as possible. Removal of the redundant slot on the
+	 * source node is deferred until the backup has completed, as the
+	 * backup's own WAL streaming may be using that slot.
 	 */
 	if (config_file_options.use_replication_slots && upstream_node_id != UNKNOWN_NODE_ID)
 	{
-		t_node_info upstream_node_record = T_NODE_INFO_INITIALIZER;
-		t_replication_slot slot_info = T_REPLICATION_SLOT_INITIALIZER;
 		RecordStatus record_status = RECORD_NOT_FOUND;
-		bool slot_exists_on_upstream = false;
 
 		record_status = get_node_record(source_conn, upstream_node_id, &upstream_node_record);
 
@@ -6861,18 +6978,12 @@ run_basebackup(t_node_info *node_record)
 					initPQExpBuffer(&event_details);
 					if (create_replication_slot(upstream_conn, node_record->slot_name, &upstream_node_record, &event_details) == false)
 					{
-						log_error("%s", event_details.data);
-
-						create_event_notification(primary_conn,
-												  &config_file_options,
-												  config_file_options.node_id,
-												  "standby_clone",
-												  false,
-												  event_details.data);
-
-						PQfinish(source_conn);
-
-						exit(ERR_DB_QUERY);
+						/*
+						 * The backup is still in progress; note the error
+						 * and report it once the backup has completed.
+						 */
+						upstream_slot_error = true;
+						appendPQExpBufferStr(&slot_error_details, event_details.data);
 					}
 
 					termPQExpBuffer(&event_details);
@@ -6881,7 +6992,56 @@ run_basebackup(t_node_info *node_record)
 				PQfinish(upstream_conn);
 			}
 		}
+	}
+
+	/* wait for the base backup to complete */
+	while (fgets(backup_output, sizeof(backup_output), backup_fp) != NULL)
+	{
+		/* pass through any stdout output (normally there is none) */
+		fputs(backup_output, stdout);
+	}
+
+	/*
+	 * As of 9.4, pg_basebackup only ever returns 0 or 1
+	 */
+	r = pclose(backup_fp);
+
+	termPQExpBuffer(&script);
+
+	if (r != 0)
+	{
+		termPQExpBuffer(&slot_error_details);
+		return ERR_BAD_BASEBACKUP;
+	}
+
+	/* check connections are still available */
+	(void)connection_ping_reconnect(primary_conn);
+
+	if (source_conn != primary_conn)
+		(void)connection_ping_reconnect(source_conn);
+
+	/* report any failure to set up the slot on the designated upstream node */
+	if (upstream_slot_error == true)
+	{
+		log_error("%s", slot_error_details.data);
+
+		create_event_notification(primary_conn,
+								  &config_file_options,
+								  config_file_options.node_id,
+								  "standby_clone",
+								  false,
+								  slot_error_details.data);
+
+		termPQExpBuffer(&slot_error_details);
+		PQfinish(source_conn);
+
+		exit(ERR_DB_QUERY);
+	}
 
+	termPQExpBuffer(&slot_error_details);
+
+	if (config_file_options.use_replication_slots && upstream_node_id != UNKNOWN_NODE_ID)
+	{
 		if (slot_info.active == false)
 		{
 			if (slot_exists_on_upstream == false)
@@ -6936,6 +7096,10 @@ run_file_backup(t_node_info *local_node_record)
 	TablespaceDataList tablespace_list = {NULL, NULL};
 	TablespaceDataListCell *cell_t = NULL;
 
+	t_parallel_command *transfer_commands = NULL;
+	int			transfer_command_count = 0;
+	int			tablespace_count = 0;
+
 	PQExpBufferData tablespace_map;
 	bool		tablespace_map_rewrite = false;
 
@@ -7135,21 +7299,29 @@ run_file_backup(t_node_info *local_node_record)
 		 */
 
 		/*
-		 * Copy all backup files from the Barman server
+		 * Copy all backup files from the Barman server.
+		 *
+		 * The base directory and tablespace transfers are executed as a pool
+		 * of concurrent workers (see below), so here we just build the
+		 * transfer command for the base directory. Note that "--progress" is
+		 * not used, as the workers' output is captured rather than streamed
+		 * to the user.
 		 */
-		maxlen_snprintf(command,
-						"rsync --progress -a --files-from=%s %s:%s/%s/data %s",
-						datadir_list_filename,
-						config_file_options.barman_host,
-						basebackups_directory,
-						backup_id,
-						local_data_directory);
-
-		(void) local_command(
-							 command,
-							 NULL);
-
-		unlink(datadir_list_filename);
+		for (cell_t = tablespace_list.head; cell_t; cell_t = cell_t->next)
+			tablespace_count++;
+
+		transfer_commands = pg_malloc0(sizeof(t_parallel_command) * (tablespace_count + 1));
+
+		initPQExpBuffer(&transfer_commands[0].command);
+		appendPQExpBuffer(&transfer_commands[0].command,
+						  "rsync -a --files-from=%s %s:%s/%s/data %s",
+						  datadir_list_filename,
+						  config_file_options.barman_host,
+						  basebackups_directory,
+						  backup_id,
+						  local_data_directory);
+		transfer_commands[0].id = 0;
+		transfer_command_count++;
 
 		/*
 		 * We must create some PGDATA subdirectories because they are not
@@ -7214,6 +7386,98 @@ run_file_backup(t_node_info *local_node_record)
 	}
 
 
+	/*
+	 * Execute the base directory and tablespace transfers as a capped pool
+	 * of concurrent workers, so cloning from Barman is not limited to the
+	 * throughput of a single rsync process.
+	 */
+	if (mode == barman)
+	{
+		for (cell_t = tablespace_list.head; cell_t; cell_t = cell_t->next)
+		{
+			bool		mapping_found = false;
+			TablespaceListCell *cell = NULL;
+			char	   *tblspc_dir_dest = NULL;
+
+			/*
+			 * Check if tablespace path matches one of the provided tablespace
+			 * mappings
+			 */
+			if (config_file_options.tablespace_mapping.head != NULL)
+			{
+				for (cell = config_file_options.tablespace_mapping.head; cell; cell = cell->next)
+				{
+					if (strcmp(cell_t->location, cell->old_dir) == 0)
+					{
+						mapping_found = true;
+						break;
+					}
+				}
+			}
+
+			tblspc_dir_dest = mapping_found == true ? cell->new_dir : cell_t->location;
+
+			create_pg_dir(tblspc_dir_dest, false);
+
+			if (cell_t->fptr != NULL)	/* cell_t->fptr == NULL iff the tablespace is
+										 * empty */
+			{
+				t_parallel_command *transfer_command = &transfer_commands[transfer_command_count];
+
+				/* close the file to ensure the contents are flushed to disk */
+				fclose(cell_t->fptr);
+
+				initPQExpBuffer(&transfer_command->command);
+				appendPQExpBuffer(&transfer_command->command,
+								  "rsync -a --files-from=%s/%s.txt %s:%s/%s/%s %s",
+								  local_repmgr_tmp_directory,
+								  cell_t->oid,
+								  config_file_options.barman_host,
+								  basebackups_directory,
+								  backup_id,
+								  cell_t->oid,
+								  tblspc_dir_dest);
+				transfer_command->id = transfer_command_count;
+				transfer_command_count++;
+			}
+		}
+
+		(void) execute_parallel_commands(transfer_commands,
+										 transfer_command_count,
+										 BARMAN_TRANSFER_MAX_WORKERS);
+
+		for (i = 0; i < transfer_command_count; i++)
+		{
+			if (transfer_commands[i].success == false)
+			{
+				log_warning(_("file transfer command failed:\n  %s"),
+							transfer_commands[i].command.data);
+			}
+
+			termPQExpBuffer(&transfer_commands[i].command);
+
+			if (transfer_commands[i].output.data != NULL)
+				termPQExpBuffer(&transfer_commands[i].output);
+		}
+
+		pg_free(transfer_commands);
+		transfer_commands = NULL;
+
+		unlink(datadir_list_filename);
+
+		for (cell_t = tablespace_list.head; cell_t; cell_t = cell_t->next)
+		{
+			if (cell_t->fptr != NULL)
+			{
+				maxlen_snprintf(filename,
+								"%s/%s.txt",
+								local_repmgr_tmp_directory,
+								cell_t->oid);
+				unlink(filename);
+			}
+		}
+	}
+
 	for (cell_t = tablespace_list.head; cell_t; cell_t = cell_t->next)
 	{
 		bool		mapping_found = false;
@@ -7248,39 +7512,10 @@ run_file_backup(t_node_info *local_node_record)
 		}
 
 		/*
-		 * Tablespace file copy
+		 * The tablespace file copy itself was carried out above, together
+		 * with the base directory transfer.
 		 */
 
-		if (mode == barman)
-		{
-			create_pg_dir(tblspc_dir_dest, false);
-
-			if (cell_t->fptr != NULL)	/* cell_t->fptr == NULL iff the tablespace is
-										 * empty */
-			{
-				/* close the file to ensure the contents are flushed to disk */
-				fclose(cell_t->fptr);
-
-				maxlen_snprintf(command,
-								"rsync --progress -a --files-from=%s/%s.txt %s:%s/%s/%s %s",
-								local_repmgr_tmp_directory,
-								cell_t->oid,
-								config_file_options.barman_host,
-								basebackups_directory,
-								backup_id,
-								cell_t->oid,
-								tblspc_dir_dest);
-				(void) local_command(command,
-									 NULL);
-				maxlen_snprintf(filename,
-								"%s/%s.txt",
-								local_repmgr_tmp_directory,
-								cell_t->oid);
-				unlink(filename);
-			}
-		}
-
-
 		/*
 		 * If a valid mapping was provided for this tablespace, arrange for it
 		 * to be remapped (if no tablespace mapping was provided, the link
@@ -7622,8 +7857,13 @@ copy_configuration_files(bool delete_after_copy)
 {
 	int			i,
 				r;
+	int			external_file_count = 0;
 	t_configfile_info *file = NULL;
 	char	   *host = NULL;
+	bool		batch_transfer_succeeded = false;
+	PQExpBufferData remote_tar_command;
+	PQExpBufferData transfer_command;
+	PQExpBufferData extract_dir;
 
 	/* get host from upstream record */
 	host = param_get(&recovery_conninfo, "host");
@@ -7633,9 +7873,126 @@ copy_configuration_files(bool delete_after_copy)
 
 	log_notice(_("copying external configuration files from upstream node \"%s\""), host);
 
+	for (i = 0; i < config_files.entries; i++)
+	{
+		if (config_files.files[i]->in_data_directory == false)
+			external_file_count++;
+	}
+
+	if (external_file_count == 0)
+		return;
+
+	/*
+	 * Bundle the whole file set into one streamed tar transfer over a single
+	 * SSH connection, rather than spawning one rsync/ssh process per file;
+	 * with larger conf.d layouts the per-file SSH handshakes quickly come to
+	 * dominate the actual transfer time.
+	 *
+	 * When copying into the data directory, the archive is extracted into a
+	 * temporary directory and the files then moved individually into place,
+	 * as the archive preserves the files' original paths.
+	 */
+	initPQExpBuffer(&remote_tar_command);
+	initPQExpBuffer(&transfer_command);
+	initPQExpBuffer(&extract_dir);
+
+	if (runtime_options.copy_external_config_files_destination == CONFIG_FILE_SAMEPATH)
+	{
+		appendPQExpBufferStr(&extract_dir, "/");
+	}
+	else
+	{
+		appendPQExpBuffer(&extract_dir,
+						  "%s/repmgr_conf_tmp",
+						  local_data_directory);
+	}
+
+	appendPQExpBufferStr(&remote_tar_command, "tar -cf - -C / ");
+
+	for (i = 0; i < config_files.entries; i++)
+	{
+		file = config_files.files[i];
+
+		if (file->in_data_directory == true)
+			continue;
+
+		appendPQExpBuffer(&remote_tar_command,
+						  "'%s' ",
+						  file->filepath[0] == '/' ? file->filepath + 1 : file->filepath);
+	}
+
+	if (runtime_options.copy_external_config_files_destination != CONFIG_FILE_SAMEPATH
+		&& create_dir(extract_dir.data) == false)
+	{
+		/* fall through to the per-file transfer below */
+	}
+	else
+	{
+		make_remote_command(runtime_options.host,
+							runtime_options.remote_user,
+							remote_tar_command.data,
+							config_file_options.ssh_options,
+							&transfer_command);
+
+		appendPQExpBuffer(&transfer_command,
+						  " | tar -xf - -C %s",
+						  extract_dir.data);
+
+		batch_transfer_succeeded = local_command(transfer_command.data, NULL);
+
+		if (batch_transfer_succeeded == false)
+		{
+			log_warning(_("unable to copy configuration files as a single archive, retrying file-by-file"));
+		}
+		else if (runtime_options.copy_external_config_files_destination != CONFIG_FILE_SAMEPATH)
+		{
+			/* move the extracted files into the data directory */
+			for (i = 0; i < config_files.entries; i++)
+			{
+				PQExpBufferData src_path;
+				PQExpBufferData dest_path;
+
+				file = config_files.files[i];
+
+				if (file->in_data_directory == true)
+					continue;
+
+				initPQExpBuffer(&src_path);
+				initPQExpBuffer(&dest_path);
+
+				appendPQExpBuffer(&src_path,
+								  "%s/%s",
+								  extract_dir.data,
+								  file->filepath[0] == '/' ? file->filepath + 1 : file->filepath);
+				appendPQExpBuffer(&dest_path,
+								  "%s/%s",
+								  local_data_directory,
+								  file->filename);
+
+				/* a failure here will be reported by the verification pass below */
+				(void) rename(src_path.data, dest_path.data);
+
+				termPQExpBuffer(&src_path);
+				termPQExpBuffer(&dest_path);
+			}
+		}
+	}
+
+	if (runtime_options.copy_external_config_files_destination != CONFIG_FILE_SAMEPATH)
+		rmdir_recursive(extract_dir.data);
+
+	termPQExpBuffer(&remote_tar_command);
+	termPQExpBuffer(&transfer_command);
+	termPQExpBuffer(&extract_dir);
+
+	/*
+	 * Verify each file arrived; if the batch transfer could not be executed
+	 * at all, copy the files individually as before.
+	 */
 	for (i = 0; i < config_files.entries; i++)
 	{
 		PQExpBufferData dest_path;
+		bool		copy_failed = false;
 
 		file = config_files.files[i];
 
@@ -7660,14 +8017,25 @@ copy_configuration_files(bool delete_after_copy)
 							  file->filename);
 		}
 
-		r = copy_remote_files(runtime_options.host, runtime_options.remote_user,
-							  file->filepath, dest_path.data, false, source_server_version_num);
+		if (batch_transfer_succeeded == true)
+		{
+			struct stat statbuf;
+
+			copy_failed = stat(dest_path.data, &statbuf) != 0;
+		}
+		else
+		{
+			r = copy_remote_files(runtime_options.host, runtime_options.remote_user,
+								  file->filepath, dest_path.data, false, source_server_version_num);
+
+			copy_failed = WEXITSTATUS(r) != 0;
+		}
 
 		/*
 		 * TODO: collate errors into list
 		 */
 
-		if (WEXITSTATUS(r))
+		if (copy_failed == true)
 		{
 			log_error(_("standby clone: unable to copy config file \"%s\""),
 					  file->filename);
@@ -8111,7 +8479,8 @@ check_sibling_nodes(NodeInfoList *sibling_nodes, SiblingNodeStats *sibling_nodes
 {
 	char		host[MAXLEN] = "";
 	NodeInfoListCell *cell;
-	int			r;
+	t_parallel_command *ssh_probes = NULL;
+	int			i;
 
 	/*
 	 * If --siblings-follow not specified, warn about any extant
@@ -8164,14 +8533,57 @@ check_sibling_nodes(NodeInfoList *sibling_nodes, SiblingNodeStats *sibling_nodes
 		return true;
 	}
 
+	/*
+	 * Probe SSH reachability of all sibling nodes concurrently; the probes
+	 * touch disjoint nodes, so the total time taken approximates the
+	 * slowest single probe rather than the sum of all probes. Each probe
+	 * mirrors test_ssh_connection(), including the alternative locations
+	 * for the "true" binary on non-Linux hosts.
+	 */
+	ssh_probes = (t_parallel_command *) pg_malloc0(sizeof(t_parallel_command) * sibling_nodes->node_count);
+
+	i = 0;
+
 	for (cell = sibling_nodes->head; cell; cell = cell->next)
 	{
 		/* get host from node record */
 		get_conninfo_value(cell->node_info->conninfo, "host", host);
-		r = test_ssh_connection(host, runtime_options.remote_user);
 
-		if (r != 0)
+		ssh_probes[i].id = cell->node_info->node_id;
+
+		initPQExpBuffer(&ssh_probes[i].command);
+
+		if (!runtime_options.remote_user[0])
+		{
+			appendPQExpBuffer(&ssh_probes[i].command,
+							  "ssh -o Batchmode=yes %s %s /bin/true 2>/dev/null"
+							  " || ssh -o Batchmode=yes %s %s /usr/bin/true 2>/dev/null",
+							  config_file_options.ssh_options, host,
+							  config_file_options.ssh_options, host);
+		}
+		else
+		{
+			appendPQExpBuffer(&ssh_probes[i].command,
+							  "ssh -o Batchmode=yes %s %s -l %s /bin/true 2>/dev/null"
+							  " || ssh -o Batchmode=yes %s %s -l %s /usr/bin/true 2>/dev/null",
+							  config_file_options.ssh_options, host, runtime_options.remote_user,
+							  config_file_options.ssh_options, host, runtime_options.remote_user);
+		}
+
+		i++;
+	}
+
+	(void) execute_parallel_commands(ssh_probes, sibling_nodes->node_count, PARALLEL_COMMAND_MAX_WORKERS);
+
+	i = 0;
+
+	for (cell = sibling_nodes->head; cell; cell = cell->next)
+	{
+		if (ssh_probes[i].success == false)
 		{
+			get_conninfo_value(cell->node_info->conninfo, "host", host);
+			log_warning(_("unable to connect to remote host \"%s\" via SSH"), host);
+
 			cell->node_info->reachable = false;
 			sibling_nodes_stats->unreachable_sibling_node_count++;
 		}
@@ -8187,8 +8599,15 @@ check_sibling_nodes(NodeInfoList *sibling_nodes, SiblingNodeStats *sibling_nodes
 				sibling_nodes_stats->min_required_free_slots++;
 			}
 		}
+
+		termPQExpBuffer(&ssh_probes[i].command);
+		termPQExpBuffer(&ssh_probes[i].output);
+
+		i++;
 	}
 
+	pg_free(ssh_probes);
+
 	if (sibling_nodes_stats->unreachable_sibling_node_count > 0)
 	{
 		if (runtime_options.force == false)
@@ -8347,15 +8766,19 @@ sibling_nodes_follow(t_node_info *local_node_record, NodeInfoList *sibling_nodes
 	char		host[MAXLEN] = "";
 	NodeInfoListCell *cell = NULL;
 	PQExpBufferData remote_command_str;
-	PQExpBufferData command_output;
+	t_parallel_command *follow_commands;
+	int			follow_command_count = 0;
+	int			i = 0;
 
 	log_notice(_("executing STANDBY FOLLOW on %i of %i siblings"),
 			   sibling_nodes->node_count - sibling_nodes_stats->unreachable_sibling_node_count,
 			   sibling_nodes->node_count);
 
+	follow_commands = (t_parallel_command *) pg_malloc0(sizeof(t_parallel_command) * sibling_nodes->node_count);
+
 	for (cell = sibling_nodes->head; cell; cell = cell->next)
 	{
-		bool		success = false;
+		t_parallel_command *follow_command;
 
 		/* skip nodes previously determined as unreachable */
 		if (cell->node_info->reachable == false)
@@ -8394,19 +8817,42 @@ sibling_nodes_follow(t_node_info *local_node_record, NodeInfoList *sibling_nodes
 								 "standby follow 2>/dev/null && echo \"1\" || echo \"0\"");
 		}
 		get_conninfo_value(cell->node_info->conninfo, "host", host);
-		log_debug("executing:\n  %s", remote_command_str.data);
 
-		initPQExpBuffer(&command_output);
+		follow_command = &follow_commands[follow_command_count++];
+		follow_command->id = cell->node_info->node_id;
 
-		success = remote_command(host,
-								 runtime_options.remote_user,
-								 remote_command_str.data,
-								 config_file_options.ssh_options,
-								 &command_output);
+		initPQExpBuffer(&follow_command->command);
+		make_remote_command(host,
+							runtime_options.remote_user,
+							remote_command_str.data,
+							config_file_options.ssh_options,
+							&follow_command->command);
 
 		termPQExpBuffer(&remote_command_str);
+	}
 
-		if (success == false || command_output.data[0] == '0')
+	/*
+	 * Dispatch the follow commands concurrently, so total re-pointing time
+	 * approaches that of the slowest single node rather than the sum of
+	 * all nodes.
+	 */
+	(void) execute_parallel_commands(follow_commands,
+									 follow_command_count,
+									 PARALLEL_COMMAND_MAX_WORKERS);
+
+	/* aggregate per-node results */
+	for (cell = sibling_nodes->head; cell; cell = cell->next)
+	{
+		t_parallel_command *follow_command;
+
+		if (cell->node_info->reachable == false)
+			continue;
+
+		follow_command = &follow_commands[i++];
+
+		if (follow_command->success == false
+			|| follow_command->output.data == NULL
+			|| follow_command->output.data[0] == '0')
 		{
 			if (cell->node_info->type == WITNESS)
 			{
@@ -8422,9 +8868,12 @@ sibling_nodes_follow(t_node_info *local_node_record, NodeInfoList *sibling_nodes
 			failed_follow_count++;
 		}
 
-		termPQExpBuffer(&command_output);
+		termPQExpBuffer(&follow_command->command);
+		termPQExpBuffer(&follow_command->output);
 	}
 
+	pg_free(follow_commands);
+
 	if (failed_follow_count == 0)
 	{
 		log_info(_("STANDBY FOLLOW successfully executed on all reachable sibling nodes"));
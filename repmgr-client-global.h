@@ -61,6 +61,7 @@ typedef struct
 	bool		csv;
 	bool		nagios;
 	bool		optformat;
+	char		output[MAXLEN];
 
 	/* standard connection options */
 	char		dbname[MAXLEN];
@@ -123,9 +124,11 @@ typedef struct
 	bool		data_directory_config;
 	bool		replication_config_owner;
 	bool		db_connection;
+	bool		switchover_preflight;
 
 	/* "node rejoin" options */
 	char		config_files[MAXLEN];
+	bool		prefetch_wal;
 
 	/* "node service" options */
 	char		action[MAXLEN];
@@ -137,10 +140,15 @@ typedef struct
 	bool		all;
 	char		event[MAXLEN];
 	int			limit;
+	char		since[MAXLEN];
+	char		until[MAXLEN];
 
 	/* "cluster cleanup" options */
 	int			keep_history;
 
+	/* "service status" options */
+	bool		timings;
+
 	/* following options for internal use */
 	char		config_archive_dir[MAXPGPATH];
 	OutputMode	output_mode; /* set through provision of --csv, --nagios or --optformat */
@@ -156,7 +164,7 @@ typedef struct
 		/* logging options */ \
 		"", false, false, false, false,	\
 		/* output options */ \
-		false, false, false,  \
+		false, false, false, "", \
 		/* database connection options */ \
 		"", "", "",	"", \
 		/* other connection options */ \
@@ -175,15 +183,17 @@ typedef struct
 		/* "node status" options */ \
 		false, \
 		/* "node check" options */ \
-		false, false, false, false, false, false, false, false,	false, false, false, false, \
+		false, false, false, false, false, false, false, false,	false, false, false, false, false, \
 		/* "node rejoin" options */ \
-		"", \
+		"", false, \
 		/* "node service" options */ \
 		"", false, false, false,  \
 		/* "cluster event" options */ \
-		false, "", CLUSTER_EVENT_LIMIT,	\
+		false, "", CLUSTER_EVENT_LIMIT,	"", "", \
 		/* "cluster cleanup" options */ \
 		0, \
+		/* "service status" options */ \
+		false, \
 		/* following options for internal use */ \
 		"/tmp", OM_TEXT, false, false \
 }
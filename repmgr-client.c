@@ -552,6 +552,10 @@ main(int argc, char **argv)
 				runtime_options.db_connection = true;
 				break;
 
+			case OPT_SWITCHOVER_PREFLIGHT:
+				runtime_options.switchover_preflight = true;
+				break;
+
 				/*--------------------
 				 * "node rejoin" options
 				 *--------------------
@@ -565,6 +569,10 @@ main(int argc, char **argv)
 				strncpy(runtime_options.config_archive_dir, optarg, MAXPGPATH);
 				break;
 
+			case OPT_PREFETCH_WAL:
+				runtime_options.prefetch_wal = true;
+				break;
+
 				/*-----------------------
 				 * "node service" options
 				 *-----------------------
@@ -597,6 +605,14 @@ main(int argc, char **argv)
 				runtime_options.limit_provided = true;
 				break;
 
+			case OPT_EVENT_SINCE:
+				strncpy(runtime_options.since, optarg, MAXLEN);
+				break;
+
+			case OPT_EVENT_UNTIL:
+				strncpy(runtime_options.until, optarg, MAXLEN);
+				break;
+
 			case OPT_ALL:
 				runtime_options.all = true;
 				break;
@@ -611,6 +627,15 @@ main(int argc, char **argv)
 				runtime_options.keep_history = repmgr_atoi(optarg, "-k/--keep-history", &cli_errors, 0);
 				break;
 
+				/*--------------------------
+				 * "service status" options
+				 *--------------------------
+				 */
+
+			case OPT_TIMINGS:
+				runtime_options.timings = true;
+				break;
+
 				/*----------------
 				 * logging options
 				 *----------------
@@ -676,6 +701,10 @@ main(int argc, char **argv)
 				runtime_options.optformat = true;
 				break;
 
+			case OPT_OUTPUT:
+				strncpy(runtime_options.output, optarg, MAXLEN);
+				break;
+
 				/*---------------------------------
 				 * undocumented options for testing
 				 *----------------------------------
@@ -1164,6 +1193,19 @@ main(int argc, char **argv)
 	{
 		runtime_options.output_mode = OM_OPTFORMAT;
 	}
+	else if (runtime_options.output[0] != '\0')
+	{
+		if (strcmp(runtime_options.output, "json-lines") == 0)
+		{
+			runtime_options.output_mode = OM_JSON_LINES;
+		}
+		else
+		{
+			item_list_append_format(&cli_errors,
+									_("unrecognized value \"%s\" provided for --output"),
+									runtime_options.output);
+		}
+	}
 
 	/*
 	 * Check for configuration file items which can be overriden by runtime
@@ -1772,6 +1814,32 @@ check_cli_parameters(const int action)
 		}
 	}
 
+	if (runtime_options.since[0] || runtime_options.until[0])
+	{
+		switch (action)
+		{
+			case CLUSTER_EVENT:
+				break;
+			default:
+				item_list_append_format(&cli_warnings,
+										_("--since/--until not required when executing %s"),
+										action_name(action));
+		}
+	}
+
+	if (runtime_options.timings == true)
+	{
+		switch (action)
+		{
+			case SERVICE_STATUS:
+				break;
+			default:
+				item_list_append_format(&cli_warnings,
+										_("--timings not required when executing %s"),
+										action_name(action));
+		}
+	}
+
 	if (runtime_options.all)
 	{
 		switch (action)
@@ -1955,7 +2023,7 @@ check_cli_parameters(const int action)
 		}
 	}
 
-	/* check only one of --csv, --nagios and --optformat  used */
+	/* check only one of --csv, --nagios, --optformat and --output used */
 	{
 		int			used_options = 0;
 
@@ -1968,11 +2036,14 @@ check_cli_parameters(const int action)
 		if (runtime_options.optformat == true)
 			used_options++;
 
+		if (runtime_options.output[0] != '\0')
+			used_options++;
+
 		if (used_options > 1)
 		{
 			/* TODO: list which options were used */
 			item_list_append(&cli_errors,
-							 "only one of --csv, --nagios and --optformat can be used");
+							 "only one of --csv, --nagios, --optformat and --output can be used");
 		}
 	}
 
@@ -4176,7 +4247,8 @@ check_node_can_attach(TimeLineID local_tli, XLogRecPtr local_xlogpos, PGconn *fo
 		 * upstream has higher timeline - check where it forked off from this node's timeline
 		 */
 		TimeLineHistoryEntry *follow_target_history = get_timeline_history(follow_target_repl_conn,
-																		   local_tli + 1);
+																		   local_tli + 1,
+																		   config_file_options.data_directory);
 
 		if (follow_target_history == NULL)
 		{
@@ -99,6 +99,12 @@
 #define OPT_REPLICATION_CONFIG_OWNER	   1046
 #define OPT_DB_CONNECTION				   1047
 #define OPT_VERIFY_BACKUP				   1048
+#define OPT_EVENT_SINCE					   1049
+#define OPT_EVENT_UNTIL					   1050
+#define OPT_TIMINGS						   1051
+#define OPT_PREFETCH_WAL				   1052
+#define OPT_OUTPUT						   1053
+#define OPT_SWITCHOVER_PREFLIGHT		   1054
 
 /* These options are for internal use only */
 #define OPT_CONFIG_ARCHIVE_DIR			   2001
@@ -153,6 +159,7 @@ static struct option long_options[] =
 	{"csv", no_argument, NULL, OPT_CSV},
 	{"nagios", no_argument, NULL, OPT_NAGIOS},
 	{"optformat", no_argument, NULL, OPT_OPTFORMAT},
+	{"output", required_argument, NULL, OPT_OUTPUT},
 
 /* "standby clone" options */
 	{"copy-external-config-files", optional_argument, NULL, OPT_COPY_EXTERNAL_CONFIG_FILES},
@@ -194,6 +201,7 @@ static struct option long_options[] =
 	{"has-passfile", no_argument, NULL, OPT_HAS_PASSFILE},
 	{"replication-connection", no_argument, NULL, OPT_REPL_CONN},
 	{"data-directory-config", no_argument, NULL, OPT_DATA_DIRECTORY_CONFIG},
+	{"switchover-preflight", no_argument, NULL, OPT_SWITCHOVER_PREFLIGHT},
 	{"replication-config-owner", no_argument, NULL, OPT_REPLICATION_CONFIG_OWNER},
 	{"db-connection", no_argument, NULL, OPT_DB_CONNECTION},
 
@@ -201,6 +209,7 @@ static struct option long_options[] =
 	{"config-files", required_argument, NULL, OPT_CONFIG_FILES},
     {"config-archive-dir", required_argument, NULL, OPT_CONFIG_ARCHIVE_DIR},
 	{"force-rewind", optional_argument, NULL, OPT_FORCE_REWIND},
+	{"prefetch-wal", no_argument, NULL, OPT_PREFETCH_WAL},
 
 /* "node service" options */
 	{"action", required_argument, NULL, OPT_ACTION},
@@ -211,10 +220,15 @@ static struct option long_options[] =
 	{"all", no_argument, NULL, OPT_ALL},
 	{"event", required_argument, NULL, OPT_EVENT},
 	{"limit", required_argument, NULL, OPT_LIMIT},
+	{"since", required_argument, NULL, OPT_EVENT_SINCE},
+	{"until", required_argument, NULL, OPT_EVENT_UNTIL},
 
 /* "cluster cleanup" options */
 	{"keep-history", required_argument, NULL, 'k'},
 
+/* "service status" options */
+	{"timings", no_argument, NULL, OPT_TIMINGS},
+
 /* undocumented options for testing */
 	{"disable-wal-receiver", no_argument, NULL, OPT_DISABLE_WAL_RECEIVER},
 	{"enable-wal-receiver", no_argument, NULL, OPT_ENABLE_WAL_RECEIVER},
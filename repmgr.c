@@ -44,9 +44,41 @@
 
 #include "voting.h"
 
+/*
+ * The hot scalar fields in repmgrdSharedState are stored as atomics, so
+ * the frequent single-value reads issued on every monitoring tick from
+ * every node (e.g. repmgr.get_upstream_node_id()) never take the LWLock;
+ * the lock is retained for writers performing multi-field updates and
+ * for the non-scalar fields (strings, timestamps).
+ *
+ * PostgreSQL 9.4 predates the atomics API; there the fields fall back to
+ * plain variables, which on all supported platforms can be read and
+ * written atomically as they are aligned 32-bit values. Memory barriers
+ * are available on all supported versions.
+ */
+#if (PG_VERSION_NUM >= 90500)
+#include "port/atomics.h"
+
+typedef pg_atomic_uint32 repmgrAtomicInt;
+
+#define repmgr_atomic_init(field, val)	pg_atomic_init_u32((field), (uint32) (val))
+#define repmgr_atomic_read(field)		((int32) pg_atomic_read_u32(field))
+#define repmgr_atomic_write(field, val) pg_atomic_write_u32((field), (uint32) (val))
+#else
+#include "storage/barrier.h"
+
+typedef int32 repmgrAtomicInt;
+
+#define repmgr_atomic_init(field, val)	(*(field) = (val))
+#define repmgr_atomic_read(field)		(*(field))
+#define repmgr_atomic_write(field, val) (*(field) = (val))
+#endif
+
 #define UNKNOWN_NODE_ID		-1
 #define ELECTION_RERUN_NOTIFICATION -2
 #define UNKNOWN_PID			-1
+#define REPMGRD_TIMINGS_LEN 2048
+#define REPMGRD_LAG_STATS_LEN 512
 
 #define TRANCHE_NAME "repmgrd"
 #define REPMGRD_STATE_FILE PGSTAT_STAT_PERMANENT_DIRECTORY "/repmgrd_state.txt"
@@ -63,19 +95,21 @@ typedef enum
 
 typedef struct repmgrdSharedState
 {
-	LWLockId	lock;			/* protects search/modification */
+	LWLockId	lock;			/* protects non-scalar fields and multi-field updates */
 	TimestampTz last_updated;
-	int			local_node_id;
-	int			repmgrd_pid;
+	repmgrAtomicInt local_node_id;
+	repmgrAtomicInt repmgrd_pid;
 	char		repmgrd_pidfile[MAXPGPATH];
-	bool		repmgrd_paused;
+	repmgrAtomicInt repmgrd_paused;	/* 0 or 1 */
+	char		repmgrd_timings[REPMGRD_TIMINGS_LEN];
+	char		repmgrd_lag_stats[REPMGRD_LAG_STATS_LEN];
 	/* streaming failover */
-	int			upstream_node_id;
+	repmgrAtomicInt upstream_node_id;
 	TimestampTz upstream_last_seen;
-	NodeVotingStatus voting_status;
-	int			current_electoral_term;
-	int			candidate_node_id;
-	bool		follow_new_primary;
+	repmgrAtomicInt voting_status;	/* NodeVotingStatus */
+	repmgrAtomicInt current_electoral_term;
+	repmgrAtomicInt candidate_node_id;
+	repmgrAtomicInt follow_new_primary;	/* 0 or 1 */
 } repmgrdSharedState;
 
 static repmgrdSharedState *shared_state = NULL;
@@ -142,6 +176,18 @@ PG_FUNCTION_INFO_V1(repmgrd_is_paused);
 Datum		get_wal_receiver_pid(PG_FUNCTION_ARGS);
 PG_FUNCTION_INFO_V1(get_wal_receiver_pid);
 
+Datum		set_repmgrd_timings(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(set_repmgrd_timings);
+
+Datum		get_repmgrd_timings(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(get_repmgrd_timings);
+
+Datum		set_repmgrd_lag_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(set_repmgrd_lag_stats);
+
+Datum		get_repmgrd_lag_stats(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(get_repmgrd_lag_stats);
+
 
 /*
  * Module load callback
@@ -211,17 +257,19 @@ repmgr_shmem_startup(void)
 		shared_state->lock = LWLockAssign();
 #endif
 
-		shared_state->local_node_id = UNKNOWN_NODE_ID;
-		shared_state->repmgrd_pid = UNKNOWN_PID;
+		repmgr_atomic_init(&shared_state->local_node_id, UNKNOWN_NODE_ID);
+		repmgr_atomic_init(&shared_state->repmgrd_pid, UNKNOWN_PID);
 		memset(shared_state->repmgrd_pidfile, 0, MAXPGPATH);
-		shared_state->repmgrd_paused = false;
-		shared_state->current_electoral_term = 0;
-		shared_state->upstream_node_id = UNKNOWN_NODE_ID;
+		repmgr_atomic_init(&shared_state->repmgrd_paused, 0);
+		memset(shared_state->repmgrd_timings, 0, REPMGRD_TIMINGS_LEN);
+		memset(shared_state->repmgrd_lag_stats, 0, REPMGRD_LAG_STATS_LEN);
+		repmgr_atomic_init(&shared_state->current_electoral_term, 0);
+		repmgr_atomic_init(&shared_state->upstream_node_id, UNKNOWN_NODE_ID);
 		/* arbitrary "magic" date to indicate this field hasn't been updated */
 		shared_state->upstream_last_seen = POSTGRES_EPOCH_JDATE;
-		shared_state->voting_status = VS_NO_VOTE;
-		shared_state->candidate_node_id = UNKNOWN_NODE_ID;
-		shared_state->follow_new_primary = false;
+		repmgr_atomic_init(&shared_state->voting_status, VS_NO_VOTE);
+		repmgr_atomic_init(&shared_state->candidate_node_id, UNKNOWN_NODE_ID);
+		repmgr_atomic_init(&shared_state->follow_new_primary, 0);
 	}
 
 	LWLockRelease(AddinShmemInitLock);
@@ -275,24 +323,21 @@ set_local_node_id(PG_FUNCTION_ARGS)
 
 	}
 
+	/* the lock serialises concurrent writers; readers are lock-free */
 	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
 
 	/* only set local_node_id once, as it should never change */
-	if (shared_state->local_node_id == UNKNOWN_NODE_ID)
+	if (repmgr_atomic_read(&shared_state->local_node_id) == UNKNOWN_NODE_ID)
 	{
-		shared_state->local_node_id = local_node_id;
+		repmgr_atomic_write(&shared_state->local_node_id, local_node_id);
 	}
 
 	/* only update if state file valid */
-	if (stored_node_id == shared_state->local_node_id)
+	if (stored_node_id == repmgr_atomic_read(&shared_state->local_node_id))
 	{
-		if (paused == 0)
-		{
-			shared_state->repmgrd_paused = false;
-		}
-		else if (paused == 1)
+		if (paused == 0 || paused == 1)
 		{
-			shared_state->repmgrd_paused = true;
+			repmgr_atomic_write(&shared_state->repmgrd_paused, paused);
 		}
 	}
 
@@ -310,9 +355,7 @@ get_local_node_id(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_NULL();
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-	local_node_id = shared_state->local_node_id;
-	LWLockRelease(shared_state->lock);
+	local_node_id = repmgr_atomic_read(&shared_state->local_node_id);
 
 	PG_RETURN_INT32(local_node_id);
 }
@@ -366,10 +409,11 @@ set_upstream_last_seen(PG_FUNCTION_ARGS)
 
 	upstream_node_id = PG_GETARG_INT32(0);
 
+	/* the lock protects the 64-bit timestamp */
 	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
 
 	shared_state->upstream_last_seen = GetCurrentTimestamp();
-	shared_state->upstream_node_id = upstream_node_id;
+	repmgr_atomic_write(&shared_state->upstream_node_id, upstream_node_id);
 	LWLockRelease(shared_state->lock);
 
 	PG_RETURN_VOID();
@@ -418,9 +462,7 @@ get_upstream_node_id(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_NULL();
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-	upstream_node_id = shared_state->upstream_node_id;
-	LWLockRelease(shared_state->lock);
+	upstream_node_id = repmgr_atomic_read(&shared_state->upstream_node_id);
 
 	PG_RETURN_INT32(upstream_node_id);
 }
@@ -439,18 +481,14 @@ set_upstream_node_id(PG_FUNCTION_ARGS)
 
 	upstream_node_id = PG_GETARG_INT32(0);
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-	local_node_id = shared_state->local_node_id;
-	LWLockRelease(shared_state->lock);
+	local_node_id = repmgr_atomic_read(&shared_state->local_node_id);
 
 	if (local_node_id == upstream_node_id)
 		ereport(ERROR,
 				(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
 				 (errmsg("upstream node id cannot be the same as the local node id"))));
 
-	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
-	shared_state->upstream_node_id = upstream_node_id;
-	LWLockRelease(shared_state->lock);
+	repmgr_atomic_write(&shared_state->upstream_node_id, upstream_node_id);
 
 	PG_RETURN_VOID();
 }
@@ -465,6 +503,7 @@ Datum
 notify_follow_primary(PG_FUNCTION_ARGS)
 {
 	int			primary_node_id = UNKNOWN_NODE_ID;
+	int			local_node_id = UNKNOWN_NODE_ID;
 
 	if (!shared_state)
 		PG_RETURN_VOID();
@@ -474,31 +513,37 @@ notify_follow_primary(PG_FUNCTION_ARGS)
 
 	primary_node_id = PG_GETARG_INT32(0);
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
+	local_node_id = repmgr_atomic_read(&shared_state->local_node_id);
 
 	/* only do something if local_node_id is initialised */
-	if (shared_state->local_node_id != UNKNOWN_NODE_ID)
+	if (local_node_id != UNKNOWN_NODE_ID)
 	{
 		if (primary_node_id == ELECTION_RERUN_NOTIFICATION)
 		{
 			elog(INFO, "node %i received notification to rerun promotion candidate election",
-				 shared_state->local_node_id);
+				 local_node_id);
 		}
 		else
 		{
 			elog(INFO, "node %i received notification to follow node %i",
-				 shared_state->local_node_id,
+				 local_node_id,
 				 primary_node_id);
 		}
 
-		LWLockRelease(shared_state->lock);
+		/* the lock serialises concurrent writers; readers are lock-free */
 		LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
-		/* Explicitly set the primary node id */
-		shared_state->candidate_node_id = primary_node_id;
-		shared_state->follow_new_primary = true;
-	}
 
-	LWLockRelease(shared_state->lock);
+		/*
+		 * Explicitly set the primary node id; the barrier ensures lock-free
+		 * readers in get_new_primary() never see the flag set before the
+		 * candidate node id is visible.
+		 */
+		repmgr_atomic_write(&shared_state->candidate_node_id, primary_node_id);
+		pg_write_barrier();
+		repmgr_atomic_write(&shared_state->follow_new_primary, 1);
+
+		LWLockRelease(shared_state->lock);
+	}
 
 	PG_RETURN_VOID();
 }
@@ -512,12 +557,12 @@ get_new_primary(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_INT32(UNKNOWN_NODE_ID);
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-
-	if (shared_state->follow_new_primary == true)
-		new_primary_node_id = shared_state->candidate_node_id;
-
-	LWLockRelease(shared_state->lock);
+	if (repmgr_atomic_read(&shared_state->follow_new_primary) == 1)
+	{
+		/* pairs with the write barrier in notify_follow_primary() */
+		pg_read_barrier();
+		new_primary_node_id = repmgr_atomic_read(&shared_state->candidate_node_id);
+	}
 
 	if (new_primary_node_id == UNKNOWN_NODE_ID)
 		PG_RETURN_INT32(UNKNOWN_NODE_ID);
@@ -532,20 +577,23 @@ reset_voting_status(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_NULL();
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-
 	/* only do something if local_node_id is initialised */
-	if (shared_state->local_node_id != UNKNOWN_NODE_ID)
+	if (repmgr_atomic_read(&shared_state->local_node_id) != UNKNOWN_NODE_ID)
 	{
-		LWLockRelease(shared_state->lock);
+		/* the lock serialises concurrent writers; readers are lock-free */
 		LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
 
-		shared_state->voting_status = VS_NO_VOTE;
-		shared_state->candidate_node_id = UNKNOWN_NODE_ID;
-		shared_state->follow_new_primary = false;
-	}
+		/*
+		 * Clear the "follow" flag first, so lock-free readers never see it
+		 * set alongside an already-reset candidate node id.
+		 */
+		repmgr_atomic_write(&shared_state->follow_new_primary, 0);
+		pg_write_barrier();
+		repmgr_atomic_write(&shared_state->voting_status, VS_NO_VOTE);
+		repmgr_atomic_write(&shared_state->candidate_node_id, UNKNOWN_NODE_ID);
 
-	LWLockRelease(shared_state->lock);
+		LWLockRelease(shared_state->lock);
+	}
 
 	PG_RETURN_VOID();
 }
@@ -563,9 +611,7 @@ get_repmgrd_pid(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_NULL();
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-	repmgrd_pid = shared_state->repmgrd_pid;
-	LWLockRelease(shared_state->lock);
+	repmgrd_pid = repmgr_atomic_read(&shared_state->repmgrd_pid);
 
 	PG_RETURN_INT32(repmgrd_pid);
 }
@@ -620,9 +666,10 @@ set_repmgrd_pid(PG_FUNCTION_ARGS)
 		elog(INFO, "set_repmgrd_pid(): provided pidfile is %s", repmgrd_pidfile);
 	}
 
+	/* the lock protects the pidfile string */
 	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
 
-	shared_state->repmgrd_pid = repmgrd_pid;
+	repmgr_atomic_write(&shared_state->repmgrd_pid, repmgrd_pid);
 	memset(shared_state->repmgrd_pidfile, 0, MAXPGPATH);
 
 	if (repmgrd_pidfile != NULL)
@@ -635,6 +682,106 @@ set_repmgrd_pid(PG_FUNCTION_ARGS)
 }
 
 
+/*
+ * Store the phase timing report provided by repmgrd; the content is treated
+ * as an opaque string.
+ */
+Datum
+set_repmgrd_timings(PG_FUNCTION_ARGS)
+{
+	char	   *repmgrd_timings = NULL;
+
+	if (!shared_state)
+		PG_RETURN_VOID();
+
+	repmgrd_timings = text_to_cstring(PG_GETARG_TEXT_PP(0));
+
+	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
+
+	memset(shared_state->repmgrd_timings, 0, REPMGRD_TIMINGS_LEN);
+	strncpy(shared_state->repmgrd_timings, repmgrd_timings, REPMGRD_TIMINGS_LEN - 1);
+
+	LWLockRelease(shared_state->lock);
+
+	PG_RETURN_VOID();
+}
+
+
+/*
+ * Returns the phase timing report last stored by repmgrd; or NULL if
+ * none stored.
+ */
+Datum
+get_repmgrd_timings(PG_FUNCTION_ARGS)
+{
+	char		repmgrd_timings[REPMGRD_TIMINGS_LEN];
+
+	if (!shared_state)
+		PG_RETURN_NULL();
+
+	memset(repmgrd_timings, 0, REPMGRD_TIMINGS_LEN);
+
+	LWLockAcquire(shared_state->lock, LW_SHARED);
+	strncpy(repmgrd_timings, shared_state->repmgrd_timings, REPMGRD_TIMINGS_LEN - 1);
+	LWLockRelease(shared_state->lock);
+
+	if (repmgrd_timings[0] == '\0')
+		PG_RETURN_NULL();
+
+	PG_RETURN_TEXT_P(cstring_to_text(repmgrd_timings));
+}
+
+
+/*
+ * Store the replication lag trend statistics provided by repmgrd; the
+ * content is treated as an opaque string.
+ */
+Datum
+set_repmgrd_lag_stats(PG_FUNCTION_ARGS)
+{
+	char	   *repmgrd_lag_stats = NULL;
+
+	if (!shared_state)
+		PG_RETURN_VOID();
+
+	repmgrd_lag_stats = text_to_cstring(PG_GETARG_TEXT_PP(0));
+
+	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
+
+	memset(shared_state->repmgrd_lag_stats, 0, REPMGRD_LAG_STATS_LEN);
+	strncpy(shared_state->repmgrd_lag_stats, repmgrd_lag_stats, REPMGRD_LAG_STATS_LEN - 1);
+
+	LWLockRelease(shared_state->lock);
+
+	PG_RETURN_VOID();
+}
+
+
+/*
+ * Returns the replication lag trend statistics last stored by repmgrd;
+ * or NULL if none stored.
+ */
+Datum
+get_repmgrd_lag_stats(PG_FUNCTION_ARGS)
+{
+	char		repmgrd_lag_stats[REPMGRD_LAG_STATS_LEN];
+
+	if (!shared_state)
+		PG_RETURN_NULL();
+
+	memset(repmgrd_lag_stats, 0, REPMGRD_LAG_STATS_LEN);
+
+	LWLockAcquire(shared_state->lock, LW_SHARED);
+	strncpy(repmgrd_lag_stats, shared_state->repmgrd_lag_stats, REPMGRD_LAG_STATS_LEN - 1);
+	LWLockRelease(shared_state->lock);
+
+	if (repmgrd_lag_stats[0] == '\0')
+		PG_RETURN_NULL();
+
+	PG_RETURN_TEXT_P(cstring_to_text(repmgrd_lag_stats));
+}
+
+
 Datum
 repmgrd_is_running(PG_FUNCTION_ARGS)
 {
@@ -644,9 +791,7 @@ repmgrd_is_running(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_NULL();
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-	repmgrd_pid = shared_state->repmgrd_pid;
-	LWLockRelease(shared_state->lock);
+	repmgrd_pid = repmgr_atomic_read(&shared_state->repmgrd_pid);
 
 	/* No PID registered - assume not running */
 	if (repmgrd_pid == UNKNOWN_PID)
@@ -680,9 +825,7 @@ repmgrd_pause(PG_FUNCTION_ARGS)
 
 	pause = PG_GETARG_BOOL(0);
 
-	LWLockAcquire(shared_state->lock, LW_EXCLUSIVE);
-	shared_state->repmgrd_paused = pause;
-	LWLockRelease(shared_state->lock);
+	repmgr_atomic_write(&shared_state->repmgrd_paused, pause ? 1 : 0);
 
 	/* write state to file */
 	file = AllocateFile(REPMGRD_STATE_FILE, PG_BINARY_W);
@@ -698,12 +841,9 @@ repmgrd_pause(PG_FUNCTION_ARGS)
 
 	initStringInfo(&buf);
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-
 	appendStringInfo(&buf, "%i:%i",
-					 shared_state->local_node_id,
+					 repmgr_atomic_read(&shared_state->local_node_id),
 					 pause ? 1 : 0);
-	LWLockRelease(shared_state->lock);
 
 	if (fwrite(buf.data, strlen(buf.data) + 1, 1, file) != 1)
 	{
@@ -726,9 +866,7 @@ repmgrd_is_paused(PG_FUNCTION_ARGS)
 	if (!shared_state)
 		PG_RETURN_NULL();
 
-	LWLockAcquire(shared_state->lock, LW_SHARED);
-	is_paused = shared_state->repmgrd_paused;
-	LWLockRelease(shared_state->lock);
+	is_paused = (repmgr_atomic_read(&shared_state->repmgrd_paused) == 1);
 
 	PG_RETURN_BOOL(is_paused);
 }
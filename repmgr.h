@@ -122,6 +122,7 @@
 #define DEFAULT_NODE_REJOIN_TIMEOUT          60  /* seconds */
 #define DEFAULT_ARCHIVE_READY_WARNING        16  /* WAL files */
 #define DEFAULT_ARCHIVE_READY_CRITICAL       128 /* WAL files */
+#define DEFAULT_ARCHIVE_READY_CACHE_TTL      5   /* seconds */
 #define	DEFAULT_REPLICATION_LAG_WARNING      300 /* seconds */
 #define DEFAULT_REPLICATION_LAG_CRITICAL     600 /* seconds */
 #define DEFAULT_WITNESS_SYNC_INTERVAL        15  /* seconds */
@@ -147,6 +148,7 @@
 #define DEFAULT_CHILD_NODES_CONNECTED_MIN_COUNT -1
 #define DEFAULT_CHILD_NODES_CONNECTED_INCLUDE_WITNESS false
 #define DEFAULT_CHILD_NODES_DISCONNECT_TIMEOUT 30 /* seconds */
+#define DEFAULT_CHILD_NODES_DISCONNECT_COMMAND_TIMEOUT 30 /* seconds */
 #define DEFAULT_SSH_OPTIONS                  "-q -o ConnectTimeout=10"
 
 
@@ -18,6 +18,7 @@
  */
 
 #include <signal.h>
+#include <sys/wait.h>
 
 #include "repmgr.h"
 #include "repmgrd.h"
@@ -92,8 +93,40 @@ static t_node_info upstream_node_info = T_NODE_INFO_INITIALIZER;
 
 static instr_time last_monitoring_update;
 
+/*
+ * Local spool for monitoring samples; samples are accumulated here each
+ * monitoring interval and written to the primary in batches (see
+ * update_monitoring_history()). If the primary is temporarily
+ * unreachable, samples collect in the spool and are replayed once the
+ * connection is restored; should the spool fill up in the meantime, the
+ * oldest samples are discarded.
+ */
+#define MONITORING_SPOOL_SIZE 128
+#define MONITORING_SPOOL_FLUSH_THRESHOLD 10
+#define MONITORING_SPOOL_FLUSH_INTERVAL 30	/* seconds */
+
+static t_monitoring_record monitoring_spool[MONITORING_SPOOL_SIZE];
+static int	monitoring_spool_start = 0;
+static int	monitoring_spool_count = 0;
+
+/*
+ * Arena for transient allocations made during a single monitoring loop
+ * iteration; reset at the top of each iteration, so steady-state monitoring
+ * causes no per-tick malloc/free traffic for arena-backed objects.
+ */
+static MemoryArena monitoring_tick_arena = T_MEMORY_ARENA_INITIALIZER;
+static instr_time last_monitoring_flush;
+
 static bool child_nodes_disconnect_command_executed = false;
 
+/*
+ * "child_nodes_disconnect_command" executes in a forked child process so the
+ * primary monitoring loop is not stalled by slow fencing scripts; the result
+ * is picked up on a subsequent monitoring iteration.
+ */
+static pid_t child_nodes_disconnect_command_pid = 0;
+static instr_time child_nodes_disconnect_command_start;
+
 static ElectionResult do_election(NodeInfoList *sibling_nodes, int *new_primary_id);
 static const char *_print_election_result(ElectionResult result);
 
@@ -115,7 +148,8 @@ static bool do_primary_failover(void);
 static bool do_upstream_standby_failover(void);
 static bool do_witness_failover(void);
 
-static bool update_monitoring_history(void);
+static bool update_monitoring_history(ReplInfo *replication_info);
+static bool flush_monitoring_spool(void);
 
 static void handle_sighup(PGconn **conn, t_server_type server_type);
 
@@ -130,6 +164,7 @@ static void remove_child_node_record(t_child_node_info_list *nodes, int node_id)
 static void clear_child_node_info_list(t_child_node_info_list *nodes);
 static void parse_child_nodes_disconnect_command(char *parsed_command, char *template, int reporting_node_id);
 static void execute_child_nodes_disconnect_command(NodeInfoList *db_child_node_records, t_child_node_info_list *local_child_nodes);
+static void reap_child_nodes_disconnect_command(void);
 
 static int try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info);
 
@@ -268,6 +303,7 @@ monitor_streaming_primary(void)
 {
 	instr_time	log_status_interval_start;
 	instr_time	child_nodes_check_interval_start;
+	instr_time	phase_start;
 	t_child_node_info_list local_child_nodes = T_CHILD_NODE_INFO_LIST_INITIALIZER;
 
 	reset_node_voting_status();
@@ -370,6 +406,10 @@ monitor_streaming_primary(void)
 
 	while (true)
 	{
+		INSTR_TIME_SET_CURRENT(phase_start);
+
+		arena_reset(&monitoring_tick_arena);
+
 		/*
 		 * TODO: cache node list here, refresh at `node_list_refresh_interval`
 		 * also return reason for inavailability so we can log it
@@ -574,10 +614,14 @@ loop:
 			handle_sighup(&local_conn, PRIMARY);
 		}
 
-		log_verbose(LOG_DEBUG, "sleeping %i seconds (parameter \"monitor_interval_secs\")",
+		record_phase_timing(TIMING_PHASE_PRIMARY_MONITORING, phase_start);
+		publish_phase_timings(local_conn);
+		write_metrics_snapshot();
+
+		log_verbose(LOG_DEBUG, "sleeping up to %i seconds (parameter \"monitor_interval_secs\")",
 					config_file_options.monitor_interval_secs);
 
-		sleep(config_file_options.monitor_interval_secs);
+		monitoring_sleep(config_file_options.monitor_interval_secs, local_conn, NULL);
 	}
 }
 
@@ -815,7 +859,12 @@ check_primary_child_nodes(t_child_node_info_list *local_child_nodes)
 	t_child_node_info_list reconnected_child_nodes = T_CHILD_NODE_INFO_LIST_INITIALIZER;
 	t_child_node_info_list new_child_nodes = T_CHILD_NODE_INFO_LIST_INITIALIZER;
 
-	bool success = get_child_nodes(local_conn, config_file_options.node_id, &db_child_node_records);
+	bool success;
+
+	/* this list is rebuilt each check; allocate it from the per-tick arena */
+	db_child_node_records.arena = &monitoring_tick_arena;
+
+	success = get_child_nodes(local_conn, config_file_options.node_id, &db_child_node_records);
 
 	if (!success)
 	{
@@ -941,18 +990,11 @@ check_primary_child_nodes(t_child_node_info_list *local_child_nodes)
 	 */
 	{
 		t_child_node_info *local_child_node_rec;
-		bool db_node_rec_found = false;
 
 		for (local_child_node_rec = local_child_nodes->head; local_child_node_rec; local_child_node_rec = local_child_node_rec->next)
 		{
-			for (cell = db_child_node_records.head; cell; cell = cell->next)
-			{
-				if (cell->node_info->node_id == local_child_node_rec->node_id)
-				{
-					db_node_rec_found = true;
-					break;
-				}
-			}
+			bool db_node_rec_found = (node_info_list_find(&db_child_node_records,
+														  local_child_node_rec->node_id) != NULL);
 
 			if (db_node_rec_found == false)
 			{
@@ -1049,6 +1091,9 @@ check_primary_child_nodes(t_child_node_info_list *local_child_nodes)
 	{
 		bool repmgrd_paused = repmgrd_is_paused(local_conn);
 
+		/* pick up the result of a previously launched command, if any */
+		reap_child_nodes_disconnect_command();
+
 		if (repmgrd_paused == false)
 		{
 			/* check criteria for execution, and execute if criteria met */
@@ -1180,9 +1225,6 @@ execute_child_nodes_disconnect_command(NodeInfoList *db_child_node_records, t_ch
 			if (most_recent_disconnect_below_threshold == false && most_recently_disconnected_node_id != UNKNOWN_NODE_ID)
 			{
 				char parsed_child_nodes_disconnect_command[MAXPGPATH];
-				int child_nodes_disconnect_command_result;
-				PQExpBufferData event_details;
-				bool success = true;
 
 				parse_child_nodes_disconnect_command(parsed_child_nodes_disconnect_command,
 													 config_file_options.child_nodes_disconnect_command,
@@ -1195,35 +1237,53 @@ execute_child_nodes_disconnect_command(NodeInfoList *db_child_node_records, t_ch
 				log_info(_("\"child_nodes_disconnect_command\" is:\n  \"%s\""),
 						 parsed_child_nodes_disconnect_command);
 
-				child_nodes_disconnect_command_result = system(parsed_child_nodes_disconnect_command);
-
-				initPQExpBuffer(&event_details);
+				/*
+				 * Execute the command in a forked child process, so a slow
+				 * command (e.g. one which talks to a load balancer API) does
+				 * not stall primary monitoring; the result will be picked up
+				 * by reap_child_nodes_disconnect_command() on a subsequent
+				 * monitoring iteration.
+				 */
+				child_nodes_disconnect_command_pid = fork();
 
-				if (child_nodes_disconnect_command_result != 0)
+				switch (child_nodes_disconnect_command_pid)
 				{
-					success = false;
+					case -1:
+					{
+						PQExpBufferData event_details;
 
-					appendPQExpBufferStr(&event_details,
-										 _("unable to execute \"child_nodes_disconnect_command\""));
+						child_nodes_disconnect_command_pid = 0;
 
-					log_error("%s", event_details.data);
-				}
-				else
-				{
-					appendPQExpBufferStr(&event_details,
-										 _("\"child_nodes_disconnect_command\" successfully executed"));
+						initPQExpBuffer(&event_details);
+						appendPQExpBuffer(&event_details,
+										  _("unable to fork child process to execute \"child_nodes_disconnect_command\": %s"),
+										  strerror(errno));
 
-					log_info("%s", event_details.data);
-				}
+						log_error("%s", event_details.data);
 
-				create_event_notification(local_conn,
-										  &config_file_options,
-										  local_node_info.node_id,
-										  "child_nodes_disconnect_command",
-										  success,
-										  event_details.data);
+						create_event_notification(local_conn,
+												  &config_file_options,
+												  local_node_info.node_id,
+												  "child_nodes_disconnect_command",
+												  false,
+												  event_details.data);
 
-				termPQExpBuffer(&event_details);
+						termPQExpBuffer(&event_details);
+						break;
+					}
+
+					/* child */
+					case 0:
+						execl("/bin/sh", "sh", "-c", parsed_child_nodes_disconnect_command, (char *) NULL);
+						_exit(127);
+
+					/* parent */
+					default:
+						INSTR_TIME_SET_CURRENT(child_nodes_disconnect_command_start);
+						log_detail(_("\"child_nodes_disconnect_command\" executing in background process %i"),
+								   (int) child_nodes_disconnect_command_pid);
+						break;
+				}
 
 				child_nodes_disconnect_command_executed = true;
 			}
@@ -1264,6 +1324,102 @@ execute_child_nodes_disconnect_command(NodeInfoList *db_child_node_records, t_ch
 }
 
 
+/*
+ * Check whether a previously launched "child_nodes_disconnect_command" has
+ * completed, and if so report its outcome. A command which has been running
+ * for longer than "child_nodes_disconnect_command_timeout" is terminated and
+ * reported as failed.
+ */
+static void
+reap_child_nodes_disconnect_command(void)
+{
+	int			stat_loc;
+	pid_t		waitpid_result;
+	bool		timed_out = false;
+	bool		success = false;
+	PQExpBufferData event_details;
+
+	if (child_nodes_disconnect_command_pid <= 0)
+		return;
+
+	waitpid_result = waitpid(child_nodes_disconnect_command_pid, &stat_loc, WNOHANG);
+
+	if (waitpid_result == 0)
+	{
+		int			elapsed_seconds;
+		instr_time	elapsed;
+
+		INSTR_TIME_SET_CURRENT(elapsed);
+		INSTR_TIME_SUBTRACT(elapsed, child_nodes_disconnect_command_start);
+		elapsed_seconds = (int) INSTR_TIME_GET_DOUBLE(elapsed);
+
+		if (elapsed_seconds < config_file_options.child_nodes_disconnect_command_timeout)
+		{
+			log_debug("\"child_nodes_disconnect_command\" (pid: %i) still executing after %i second(s)",
+					  (int) child_nodes_disconnect_command_pid,
+					  elapsed_seconds);
+			return;
+		}
+
+		log_warning(_("\"child_nodes_disconnect_command\" (pid: %i) did not complete after %i second(s), terminating it"),
+					(int) child_nodes_disconnect_command_pid,
+					elapsed_seconds);
+		log_detail(_("\"child_nodes_disconnect_command_timeout\" set to %i seconds"),
+				   config_file_options.child_nodes_disconnect_command_timeout);
+
+		timed_out = true;
+		(void) kill(child_nodes_disconnect_command_pid, SIGKILL);
+		waitpid_result = waitpid(child_nodes_disconnect_command_pid, &stat_loc, 0);
+	}
+
+	initPQExpBuffer(&event_details);
+
+	if (waitpid_result < 0)
+	{
+		appendPQExpBuffer(&event_details,
+						  _("unable to retrieve exit status of \"child_nodes_disconnect_command\": %s"),
+						  strerror(errno));
+
+		log_error("%s", event_details.data);
+	}
+	else if (timed_out == true)
+	{
+		appendPQExpBuffer(&event_details,
+						  _("\"child_nodes_disconnect_command\" terminated after exceeding \"child_nodes_disconnect_command_timeout\" (%i seconds)"),
+						  config_file_options.child_nodes_disconnect_command_timeout);
+
+		log_error("%s", event_details.data);
+	}
+	else if (WIFEXITED(stat_loc) && WEXITSTATUS(stat_loc) == 0)
+	{
+		success = true;
+
+		appendPQExpBufferStr(&event_details,
+							 _("\"child_nodes_disconnect_command\" successfully executed"));
+
+		log_info("%s", event_details.data);
+	}
+	else
+	{
+		appendPQExpBufferStr(&event_details,
+							 _("unable to execute \"child_nodes_disconnect_command\""));
+
+		log_error("%s", event_details.data);
+	}
+
+	create_event_notification(local_conn,
+							  &config_file_options,
+							  local_node_info.node_id,
+							  "child_nodes_disconnect_command",
+							  success,
+							  event_details.data);
+
+	termPQExpBuffer(&event_details);
+
+	child_nodes_disconnect_command_pid = 0;
+}
+
+
 /*
  * repmgrd running on a standby server
  */
@@ -1272,17 +1428,24 @@ monitor_streaming_standby(void)
 {
 	RecordStatus record_status;
 	instr_time	log_status_interval_start;
+	instr_time	phase_start;
 
 	MonitoringState local_monitoring_state = MS_NORMAL;
 	instr_time	local_degraded_monitoring_start;
 
 	int last_known_upstream_node_id = UNKNOWN_NODE_ID;
 
+	ReplInfo	tick_replication_info;
+	int			tick_stored_local_node_id = UNKNOWN_NODE_ID;
+	RecordStatus tick_record_status = RECORD_NOT_FOUND;
+	bool		tick_snapshot_valid = false;
+
 	log_debug("monitor_streaming_standby()");
 
 	reset_node_voting_status();
 
 	INSTR_TIME_SET_ZERO(last_monitoring_update);
+	INSTR_TIME_SET_ZERO(last_monitoring_flush);
 
 	/*
 	 * If no upstream node id is specified in the metadata, we'll try and
@@ -1466,6 +1629,10 @@ monitor_streaming_standby(void)
 	{
 		bool upstream_check_result;
 
+		INSTR_TIME_SET_CURRENT(phase_start);
+
+		arena_reset(&monitoring_tick_arena);
+
 		log_verbose(LOG_DEBUG, "checking %s", upstream_node_info.conninfo);
 
 		if (upstream_node_info.type == PRIMARY)
@@ -1939,6 +2106,33 @@ monitor_streaming_standby(void)
 
 loop:
 
+		/*
+		 * Refresh the local node's per-tick status set (replication info,
+		 * stored node ID and node record) as a single batched round trip
+		 * where possible; the values are consumed at various points below.
+		 * If the snapshot can't be taken (e.g. local connection down), the
+		 * consumers fall back to individual queries.
+		 */
+		tick_snapshot_valid = false;
+
+		if (PQstatus(local_conn) == CONNECTION_OK)
+		{
+			init_replication_info(&tick_replication_info);
+
+			tick_snapshot_valid = get_standby_monitoring_snapshot(local_conn,
+																  local_node_info.node_id,
+																  &tick_replication_info,
+																  &tick_stored_local_node_id,
+																  &local_node_info,
+																  &tick_record_status);
+
+			if (tick_snapshot_valid == true)
+			{
+				update_replication_metrics(&tick_replication_info);
+				publish_replication_lag_stats(local_conn);
+			}
+		}
+
 		/* emit "still alive" log message at regular intervals, if requested */
 		if (config_file_options.log_status_interval > 0)
 		{
@@ -2004,27 +2198,29 @@ loop:
 			}
 		}
 
-		if (PQstatus(primary_conn) == CONNECTION_OK && config_file_options.monitoring_history == true)
+		if (config_file_options.monitoring_history == true)
 		{
-			bool success = update_monitoring_history();
+			/*
+			 * The sample is spooled locally even if the primary is not
+			 * currently reachable; in that case, attempt to restore the
+			 * primary connection so the spooled samples can be written out.
+			 */
+			(void) update_monitoring_history(tick_snapshot_valid ? &tick_replication_info : NULL);
 
-			if (success == false && PQstatus(primary_conn) != CONNECTION_OK && upstream_node_info.type == STANDBY)
+			if (PQstatus(primary_conn) != CONNECTION_OK && upstream_node_info.type == STANDBY)
 			{
+				log_verbose(LOG_WARNING, _("monitoring_history requested but primary connection not available"));
+
 				primary_conn = establish_primary_db_connection(local_conn, false);
 
 				if (PQstatus(primary_conn) == CONNECTION_OK)
 				{
-					(void)update_monitoring_history();
+					(void) flush_monitoring_spool();
 				}
 			}
 		}
 		else
 		{
-			if (config_file_options.monitoring_history == true)
-			{
-				log_verbose(LOG_WARNING, _("monitoring_history requested but primary connection not available"));
-			}
-
 			/*
 			 * if monitoring not in use, we'll need to ensure the local connection
 			 * handle isn't stale
@@ -2132,7 +2328,10 @@ loop:
 			 * If the local node was restarted, we'll need to reinitialise values
 			 * stored in shared memory.
 			 */
-			stored_local_node_id = repmgrd_get_local_node_id(local_conn);
+			if (tick_snapshot_valid == true)
+				stored_local_node_id = tick_stored_local_node_id;
+			else
+				stored_local_node_id = repmgrd_get_local_node_id(local_conn);
 
 			if (stored_local_node_id == UNKNOWN_NODE_ID)
 			{
@@ -2191,7 +2390,9 @@ loop:
 			handle_sighup(&local_conn, STANDBY);
 		}
 
-		refresh_node_record(local_conn, local_node_info.node_id, &local_node_info);
+		/* the node record will usually have been refreshed by the tick snapshot above */
+		if (tick_snapshot_valid == false || tick_record_status != RECORD_FOUND)
+			refresh_node_record(local_conn, local_node_info.node_id, &local_node_info);
 
 		if (local_monitoring_state == MS_NORMAL && last_known_upstream_node_id != local_node_info.upstream_node_id)
 		{
@@ -2226,11 +2427,15 @@ loop:
 			}
 		}
 
-		log_verbose(LOG_DEBUG, "sleeping %i seconds (parameter \"monitor_interval_secs\")",
+		record_phase_timing(TIMING_PHASE_STANDBY_MONITORING, phase_start);
+		publish_phase_timings(local_conn);
+		write_metrics_snapshot();
+
+		log_verbose(LOG_DEBUG, "sleeping up to %i seconds (parameter \"monitor_interval_secs\")",
 					config_file_options.monitor_interval_secs);
 
 
-		sleep(config_file_options.monitor_interval_secs);
+		monitoring_sleep(config_file_options.monitor_interval_secs, upstream_conn, local_conn);
 	}
 }
 
@@ -2245,6 +2450,9 @@ monitor_streaming_witness(void)
 
 	int primary_node_id = UNKNOWN_NODE_ID;
 
+	/* digest of the node records most recently synchronised from the primary */
+	char		node_records_digest[MAXLEN] = "";
+
 	reset_node_voting_status();
 
 	log_debug("monitor_streaming_witness()");
@@ -2271,7 +2479,7 @@ monitor_streaming_witness(void)
 			: "repmgrd_upstream_reconnect";
 
 		/* synchronise local copy of "repmgr.nodes", in case it was stale */
-		witness_copy_node_records(primary_conn, local_conn);
+		witness_sync_node_records(primary_conn, local_conn, node_records_digest);
 
 		/*
 		 * refresh upstream node record from primary, so it's as up-to-date
@@ -2691,7 +2899,7 @@ loop:
 				}
 
 				log_debug("synchronising witness node records");
-				witness_copy_node_records(primary_conn, local_conn);
+				witness_sync_node_records(primary_conn, local_conn, node_records_digest);
 
 				INSTR_TIME_SET_CURRENT(witness_sync_interval_start);
 			}
@@ -2740,10 +2948,10 @@ loop:
 			handle_sighup(&local_conn, WITNESS);
 		}
 
-		log_verbose(LOG_DEBUG, "sleeping %i seconds (parameter \"monitor_interval_secs\")",
+		log_verbose(LOG_DEBUG, "sleeping up to %i seconds (parameter \"monitor_interval_secs\")",
 					config_file_options.monitor_interval_secs);
 
-		sleep(config_file_options.monitor_interval_secs);
+		monitoring_sleep(config_file_options.monitor_interval_secs, primary_conn, local_conn);
 	}
 
 	return;
@@ -2757,6 +2965,10 @@ do_primary_failover(void)
 	bool final_result = false;
 	NodeInfoList sibling_nodes = T_NODE_INFO_LIST_INITIALIZER;
 	int new_primary_id = UNKNOWN_NODE_ID;
+	instr_time	failover_start;
+	instr_time	election_start;
+
+	INSTR_TIME_SET_CURRENT(failover_start);
 
 	/*
 	 * Double-check status of the local connection
@@ -2858,7 +3070,10 @@ do_primary_failover(void)
 	}
 
 	/* attempt to initiate voting process */
+	INSTR_TIME_SET_CURRENT(election_start);
 	election_result = do_election(&sibling_nodes, &new_primary_id);
+	record_phase_timing(TIMING_PHASE_ELECTION, election_start);
+	update_election_metrics(_print_election_result(election_result));
 
 	/* TODO add pre-event notification here */
 	failover_state = FAILOVER_STATE_UNKNOWN;
@@ -2879,6 +3094,7 @@ do_primary_failover(void)
 		{
 			log_notice(_("election cancelled"));
 			clear_node_info_list(&sibling_nodes);
+			record_phase_timing(TIMING_PHASE_FAILOVER, failover_start);
 			return false;
 		}
 
@@ -3146,38 +3362,46 @@ do_primary_failover(void)
 	/* we no longer care about our former siblings */
 	clear_node_info_list(&sibling_nodes);
 
+	record_phase_timing(TIMING_PHASE_FAILOVER, failover_start);
+
 	return final_result;
 }
 
 
+/*
+ * If the caller has already retrieved the local node's replication status
+ * this tick (see get_standby_monitoring_snapshot()), it can be passed in
+ * as "replication_info" to avoid a redundant query; otherwise pass NULL
+ * and the status will be fetched here.
+ */
 static bool
-update_monitoring_history(void)
+update_monitoring_history(ReplInfo *replication_info)
 {
-	ReplInfo	replication_info;
+	ReplInfo	fetched_replication_info;
 	XLogRecPtr	primary_last_wal_location = InvalidXLogRecPtr;
+	t_monitoring_record *sample;
 
 	long long unsigned int apply_lag_bytes = 0;
 	long long unsigned int replication_lag_bytes = 0;
 
-	/* both local and primary connections must be available */
-	if (PQstatus(primary_conn) != CONNECTION_OK)
-	{
-		log_warning(_("primary connection is not available, unable to update monitoring history"));
-		return false;
-	}
-
+	/* the local connection must be available to sample replication status */
 	if (PQstatus(local_conn) != CONNECTION_OK)
 	{
 		log_warning(_("local connection is not available, unable to update monitoring history"));
 		return false;
 	}
 
-	init_replication_info(&replication_info);
-
-	if (get_replication_info(local_conn, STANDBY, &replication_info) == false)
+	if (replication_info == NULL)
 	{
-		log_warning(_("unable to retrieve replication status information, unable to update monitoring history"));
-		return false;
+		init_replication_info(&fetched_replication_info);
+
+		if (get_replication_info(local_conn, STANDBY, &fetched_replication_info) == false)
+		{
+			log_warning(_("unable to retrieve replication status information, unable to update monitoring history"));
+			return false;
+		}
+
+		replication_info = &fetched_replication_info;
 	}
 
 	/*
@@ -3185,24 +3409,40 @@ update_monitoring_history(void)
 	 * a new primary, or when it has dropped back to archive recovery.
 	 * As long as we can connect to the primary, we can still provide lag information.
 	 */
-	if (replication_info.receiving_streamed_wal == false)
+	if (replication_info->receiving_streamed_wal == false)
 	{
 		log_verbose(LOG_WARNING, _("standby %i not connected to streaming replication"),
 					local_node_info.node_id);
 	}
 
-	primary_last_wal_location = get_primary_current_lsn(primary_conn);
+	if (PQstatus(primary_conn) == CONNECTION_OK)
+	{
+		primary_last_wal_location = get_primary_current_lsn(primary_conn);
+
+		if (primary_last_wal_location == InvalidXLogRecPtr)
+		{
+			log_warning(_("unable to retrieve primary's current LSN"));
+		}
+	}
 
+	/*
+	 * If the primary's current LSN is unavailable (e.g. because the
+	 * primary is unreachable), no sample is recorded: the true replication
+	 * lag is unknown in this state, and spooling a placeholder zero would
+	 * misrepresent an outage as zero lag to consumers of
+	 * "repmgr.monitoring_history". Samples already spooled are written out
+	 * once the connection is restored.
+	 */
 	if (primary_last_wal_location == InvalidXLogRecPtr)
 	{
-		log_warning(_("unable to retrieve primary's current LSN"));
+		log_verbose(LOG_DEBUG, "update_monitoring_history(): primary LSN unavailable, sample not recorded");
 		return false;
 	}
 
 	/* calculate apply lag in bytes */
-	if (replication_info.last_wal_receive_lsn >= replication_info.last_wal_replay_lsn)
+	if (replication_info->last_wal_receive_lsn >= replication_info->last_wal_replay_lsn)
 	{
-		apply_lag_bytes = (long long unsigned int) (replication_info.last_wal_receive_lsn - replication_info.last_wal_replay_lsn);
+		apply_lag_bytes = (long long unsigned int) (replication_info->last_wal_receive_lsn - replication_info->last_wal_replay_lsn);
 	}
 	else
 	{
@@ -3212,9 +3452,9 @@ update_monitoring_history(void)
 
 	/* calculate replication lag in bytes */
 
-	if (primary_last_wal_location >= replication_info.last_wal_receive_lsn)
+	if (primary_last_wal_location >= replication_info->last_wal_receive_lsn)
 	{
-		replication_lag_bytes = (long long unsigned int) (primary_last_wal_location - replication_info.last_wal_receive_lsn);
+		replication_lag_bytes = (long long unsigned int) (primary_last_wal_location - replication_info->last_wal_receive_lsn);
 		log_debug("replication lag in bytes is: %llu", replication_lag_bytes);
 	}
 	else
@@ -3225,24 +3465,95 @@ update_monitoring_history(void)
 		 */
 		log_warning("primary xlog location (%X/%X) is behind the standby receive location (%X/%X)",
 					format_lsn(primary_last_wal_location),
-					format_lsn(replication_info.last_wal_receive_lsn));
+					format_lsn(replication_info->last_wal_receive_lsn));
 		replication_lag_bytes = 0;
 	}
 
-	add_monitoring_record(primary_conn,
-						  local_conn,
-						  primary_node_id,
-						  local_node_info.node_id,
-						  replication_info.current_timestamp,
-						  primary_last_wal_location,
-						  replication_info.last_wal_receive_lsn,
-						  replication_info.last_xact_replay_timestamp,
-						  replication_lag_bytes,
-						  apply_lag_bytes);
+	/* append the sample to the spool */
+	if (monitoring_spool_count == MONITORING_SPOOL_SIZE)
+	{
+		/* spool full - discard the oldest sample */
+		log_verbose(LOG_WARNING, _("monitoring spool full, discarding oldest sample"));
+		monitoring_spool_start = (monitoring_spool_start + 1) % MONITORING_SPOOL_SIZE;
+		monitoring_spool_count--;
+	}
+
+	sample = &monitoring_spool[(monitoring_spool_start + monitoring_spool_count) % MONITORING_SPOOL_SIZE];
+	monitoring_spool_count++;
+
+	sample->primary_node_id = primary_node_id;
+	sample->standby_node_id = local_node_info.node_id;
+	strncpy(sample->monitor_standby_timestamp, replication_info->current_timestamp, MAXLEN);
+	strncpy(sample->last_xact_replay_timestamp, replication_info->last_xact_replay_timestamp, MAXLEN);
+	sample->primary_last_wal_location = primary_last_wal_location;
+	sample->last_wal_receive_lsn = replication_info->last_wal_receive_lsn;
+	sample->replication_lag_bytes = replication_lag_bytes;
+	sample->apply_lag_bytes = apply_lag_bytes;
 
 	INSTR_TIME_SET_CURRENT(last_monitoring_update);
 
-	log_verbose(LOG_DEBUG, "update_monitoring_history(): monitoring history update sent");
+	log_verbose(LOG_DEBUG, "update_monitoring_history(): %i monitoring sample(s) spooled",
+				monitoring_spool_count);
+
+	/* write out the spool in batches, on its own cadence */
+	if (PQstatus(primary_conn) == CONNECTION_OK
+		&& (monitoring_spool_count >= MONITORING_SPOOL_FLUSH_THRESHOLD
+			|| INSTR_TIME_IS_ZERO(last_monitoring_flush)
+			|| calculate_elapsed(last_monitoring_flush) >= MONITORING_SPOOL_FLUSH_INTERVAL))
+	{
+		(void) flush_monitoring_spool();
+	}
+
+	return true;
+}
+
+
+/*
+ * Write all spooled monitoring samples to the primary as a single batch.
+ * If the batch could not be dispatched, the samples are retained and will
+ * be replayed by a subsequent flush attempt.
+ */
+static bool
+flush_monitoring_spool(void)
+{
+	t_monitoring_record *records;
+	int			record_count = monitoring_spool_count;
+	int			i;
+	bool		success;
+
+	if (record_count == 0)
+		return true;
+
+	if (PQstatus(primary_conn) != CONNECTION_OK)
+	{
+		log_warning(_("primary connection is not available, unable to write monitoring history"));
+		return false;
+	}
+
+	/* unwrap the ring buffer into a contiguous batch */
+	records = (t_monitoring_record *) pg_malloc0(sizeof(t_monitoring_record) * record_count);
+
+	for (i = 0; i < record_count; i++)
+	{
+		memcpy(&records[i],
+			   &monitoring_spool[(monitoring_spool_start + i) % MONITORING_SPOOL_SIZE],
+			   sizeof(t_monitoring_record));
+	}
+
+	success = add_monitoring_records(primary_conn, local_conn, records, record_count);
+
+	pg_free(records);
+
+	if (success == false)
+		return false;
+
+	monitoring_spool_start = 0;
+	monitoring_spool_count = 0;
+
+	INSTR_TIME_SET_CURRENT(last_monitoring_flush);
+
+	log_verbose(LOG_DEBUG, "flush_monitoring_spool(): %i monitoring sample(s) written",
+				record_count);
 
 	return true;
 }
@@ -3711,24 +4022,29 @@ static void
 notify_followers(NodeInfoList *standby_nodes, int follow_node_id)
 {
 	NodeInfoListCell *cell;
+	bool	   *notification_sent;
+	int			i;
 
 	log_info(_("%i followers to notify"),
 			 standby_nodes->node_count);
 
-	for (cell = standby_nodes->head; cell; cell = cell->next)
-	{
-		log_verbose(LOG_DEBUG, "intending to notify node %i...", cell->node_info->node_id);
-
-		if (PQstatus(cell->node_info->conn) != CONNECTION_OK)
-		{
-			log_info(_("reconnecting to node \"%s\" (ID: %i)..."),
-					 cell->node_info->node_name,
-					 cell->node_info->node_id);
+	/*
+	 * Reconnect to any followers whose connection has gone away; this is
+	 * done for all nodes concurrently so an unreachable follower delays
+	 * the others by no more than its connection timeout.
+	 */
+	establish_node_connections_parallel(standby_nodes);
 
-			close_connection(&cell->node_info->conn);
+	notification_sent = (bool *) pg_malloc0(sizeof(bool) * standby_nodes->node_count);
 
-			cell->node_info->conn = establish_db_connection(cell->node_info->conninfo, false);
-		}
+	/*
+	 * Dispatch all notifications before collecting any results, so the
+	 * fan-out completes in roughly the time taken by the slowest single
+	 * node rather than the sum of all nodes.
+	 */
+	for (cell = standby_nodes->head, i = 0; cell; cell = cell->next, i++)
+	{
+		log_verbose(LOG_DEBUG, "intending to notify node %i...", cell->node_info->node_id);
 
 		if (PQstatus(cell->node_info->conn) != CONNECTION_OK)
 		{
@@ -3754,8 +4070,23 @@ notify_followers(NodeInfoList *standby_nodes, int follow_node_id)
 					   cell->node_info->node_id,
 					   follow_node_id);
 		}
-		notify_follow_primary(cell->node_info->conn, follow_node_id);
+		notification_sent[i] = notify_follow_primary_send(cell->node_info->conn, follow_node_id);
 	}
+
+	for (cell = standby_nodes->head, i = 0; cell; cell = cell->next, i++)
+	{
+		if (notification_sent[i] == false)
+			continue;
+
+		if (notify_follow_primary_collect(cell->node_info->conn) == false)
+		{
+			log_warning(_("unable to notify node \"%s\" (ID: %i)"),
+						cell->node_info->node_name,
+						cell->node_info->node_id);
+		}
+	}
+
+	pg_free(notification_sent);
 }
 
 
@@ -4325,6 +4656,13 @@ do_election(NodeInfoList *sibling_nodes, int *new_primary_id)
 
 	initPQExpBuffer(&nodes_with_primary_visible);
 
+	/*
+	 * Connect to all sibling nodes concurrently, so the election phase is
+	 * bounded by the slowest reachable sibling (or a single connection
+	 * timeout) rather than the sum of all connection attempts.
+	 */
+	establish_node_connections_parallel(sibling_nodes);
+
 	for (cell = sibling_nodes->head; cell; cell = cell->next)
 	{
 		ReplInfo	sibling_replication_info;
@@ -4336,10 +4674,11 @@ do_election(NodeInfoList *sibling_nodes, int *new_primary_id)
 		/* assume the worst case */
 		cell->node_info->node_status = NODE_STATUS_UNKNOWN;
 
-		cell->node_info->conn = establish_db_connection(cell->node_info->conninfo, false);
-
 		if (PQstatus(cell->node_info->conn) != CONNECTION_OK)
 		{
+			log_warning(_("unable to connect to node \"%s\" (ID: %i), skipping"),
+						cell->node_info->node_name,
+						cell->node_info->node_id);
 			close_connection(&cell->node_info->conn);
 
 			continue;
@@ -4862,13 +5201,26 @@ format_failover_state(FailoverState failover_state)
 static void
 handle_sighup(PGconn **conn, t_server_type server_type)
 {
+	bool		conninfo_changed = false;
+
 	log_notice(_("received SIGHUP, reloading configuration"));
 
-	if (reload_config(server_type))
+	if (reload_config(server_type, &conninfo_changed) == true)
 	{
-		close_connection(conn);
+		/*
+		 * Only re-establish the monitoring connection if "conninfo" itself
+		 * was changed; all other parameters take effect without disturbing
+		 * the existing connection, so a routine fleet-wide reload doesn't
+		 * cause a burst of reconnections.
+		 */
+		if (conninfo_changed == true)
+		{
+			log_notice(_("\"conninfo\" changed, re-establishing database connection"));
+
+			close_connection(conn);
 
-		*conn = establish_db_connection(config_file_options.conninfo, true);
+			*conn = establish_db_connection(config_file_options.conninfo, true);
+		}
 	}
 
 	if (*config_file_options.log_file)
@@ -5123,7 +5475,8 @@ check_node_can_follow(PGconn *local_conn, XLogRecPtr local_xlogpos, PGconn *foll
 		 * upstream has higher timeline - check where it forked off from this node's timeline
 		 */
 		follow_target_history = get_timeline_history(follow_target_repl_conn,
-													 local_identification.timeline + 1);
+													 local_identification.timeline + 1,
+													 config_file_options.data_directory);
 
 		if (follow_target_history == NULL)
 		{
@@ -5350,18 +5703,11 @@ parse_child_nodes_disconnect_command(char *parsed_command, char *template, int r
 int
 try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info)
 {
-	t_conninfo_param_list conninfo_params = T_CONNINFO_PARAM_LIST_INITIALIZER;
+	t_conninfo_param_list *conninfo_params;
 	int			i;
 	int			max_attempts = config_file_options.reconnect_attempts;
 
-	initialize_conninfo_params(&conninfo_params, false);
-
-	/* we assume by now the conninfo string is parseable */
-	(void) parse_conninfo_string(node_info->conninfo, &conninfo_params, NULL, false);
-
-	/* set some default values if not explicitly provided */
-	param_set_ine(&conninfo_params, "connect_timeout", "2");
-	param_set_ine(&conninfo_params, "fallback_application_name", "repmgr");
+	conninfo_params = get_reconnect_conninfo_params(node_info);
 
 	for (i = 0; i < max_attempts; i++)
 	{
@@ -5370,7 +5716,7 @@ try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info)
 				 node_info->node_id,
 				 i + 1, max_attempts);
 
-		if (is_server_available_params(&conninfo_params) == true)
+		if (is_server_available_params(conninfo_params) == true)
 		{
 			PGconn	   *our_conn;
 
@@ -5383,12 +5729,10 @@ try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info)
 			 * connection denied due to connection exhaustion, by falling back to
 			 * degraded monitoring (make configurable)
 			 */
-			our_conn = establish_db_connection_by_params(&conninfo_params, false);
+			our_conn = establish_db_connection_by_params(conninfo_params, false);
 
 			if (PQstatus(our_conn) == CONNECTION_OK)
 			{
-				free_conninfo_params(&conninfo_params);
-
 				log_info(_("connection to node \"%s\" (ID: %i) succeeded"),
 						 node_info->node_name,
 						 node_info->node_id);
@@ -5433,9 +5777,11 @@ try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info)
 		if (i + 1 < max_attempts)
 		{
 			int j;
+			int sleep_time = reconnect_interval_backoff(i);
+
 			log_info(_("sleeping %i seconds until next reconnection attempt"),
-					 config_file_options.reconnect_interval);
-			for (j = 0; j < config_file_options.reconnect_interval; j++)
+					 sleep_time);
+			for (j = 0; j < sleep_time; j++)
 			{
 				int new_primary_node_id;
 				if (get_new_primary(local_conn, &new_primary_node_id) == true && new_primary_node_id != UNKNOWN_NODE_ID)
@@ -5449,7 +5795,6 @@ try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info)
 						log_notice(_("received notification that new primary is node %i"), new_primary_node_id);
 					}
 
-					free_conninfo_params(&conninfo_params);
 					return new_primary_node_id;
 				}
 				sleep(1);
@@ -5464,7 +5809,5 @@ try_primary_reconnect(PGconn **conn, PGconn *local_conn, t_node_info *node_info)
 
 	node_info->node_status = NODE_STATUS_DOWN;
 
-	free_conninfo_params(&conninfo_params);
-
 	return UNKNOWN_NODE_ID;
 }
@@ -18,9 +18,12 @@
  */
 
 #include <stdio.h>
+#include <errno.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <sys/select.h>
 #include <sys/stat.h>
+#include <sys/time.h>
 
 
 #include "repmgr.h"
@@ -56,6 +59,94 @@ instr_time	degraded_monitoring_start;
  */
 volatile sig_atomic_t got_SIGHUP = false;
 
+/*
+ * Cache of pre-built conninfo parameter lists for reconnection attempts
+ * (see get_reconnect_conninfo_params())
+ */
+#define RECONNECT_PARAMS_CACHE_SIZE 4
+
+typedef struct
+{
+	int			node_id;
+	char		conninfo[MAXLEN];
+	t_conninfo_param_list conninfo_params;
+} t_reconnect_params_cache_entry;
+
+static t_reconnect_params_cache_entry reconnect_params_cache[RECONNECT_PARAMS_CACHE_SIZE];
+static int	reconnect_params_cache_used = 0;
+
+/* cap on the exponential reconnection backoff (see reconnect_interval_backoff()) */
+#define RECONNECT_BACKOFF_MAX_MULTIPLIER 8
+
+/*
+ * In-process timing histograms for the major monitoring/failover phases
+ * (see record_phase_timing())
+ */
+#define TIMING_HISTOGRAM_BUCKETS 16
+
+/* minimum interval in seconds between timing publications */
+#define TIMING_PUBLISH_INTERVAL 60
+
+typedef struct
+{
+	long		count;
+	long		total_ms;
+	long		max_ms;
+	long		last_ms;
+	long		buckets[TIMING_HISTOGRAM_BUCKETS];
+} t_phase_timing;
+
+static t_phase_timing phase_timings[TIMING_PHASE_COUNT];
+static bool phase_timings_updated = false;
+static time_t phase_timings_last_published = 0;
+
+static const char *phase_timing_names[] = {
+	"primary_monitoring",
+	"standby_monitoring",
+	"election",
+	"failover"
+};
+
+/*
+ * Metrics snapshot written to "repmgrd_metrics_file", if configured
+ * (see write_metrics_snapshot())
+ */
+static ReplInfo metrics_replication_info;
+static bool metrics_replication_info_valid = false;
+static char metrics_last_election_result[MAXLEN] = "none";
+
+/*
+ * Ring buffer of per-tick LSN samples, populated as a side-effect of
+ * update_replication_metrics() and used to derive replication throughput
+ * and lag trend statistics (see calculate_replication_lag_stats()).
+ * At the default monitor_interval_secs of 2, 128 samples cover a little
+ * over four minutes of history.
+ */
+#define LSN_SAMPLE_RING_SIZE 128
+
+typedef struct
+{
+	time_t		sample_time;
+	XLogRecPtr	receive_lsn;
+	XLogRecPtr	replay_lsn;
+} LSNSample;
+
+typedef struct
+{
+	int			samples;
+	long		window_seconds;
+	long long	receive_rate;	/* bytes/second */
+	long long	apply_rate;		/* bytes/second */
+	long long	lag_bytes;
+	long long	estimated_catchup_seconds;	/* -1: not catching up */
+} ReplicationLagStats;
+
+static LSNSample lsn_sample_ring[LSN_SAMPLE_RING_SIZE];
+static int	lsn_sample_count = 0;
+static int	lsn_sample_next = 0;
+
+static bool calculate_replication_lag_stats(ReplicationLagStats *stats);
+
 static void show_help(void);
 static void show_usage(void);
 static void daemonize_process(void);
@@ -518,6 +609,22 @@ main(int argc, char **argv)
 		daemonize_process();
 	}
 
+	/*
+	 * Fork the asynchronous log writer (if requested) after daemonizing,
+	 * so it becomes a child of the daemon process.
+	 */
+	if (config_file_options.log_async == true)
+	{
+		if (logger_enable_async() == true)
+		{
+			log_info(_("asynchronous logging enabled"));
+		}
+		else
+		{
+			log_warning(_("unable to enable asynchronous logging, continuing with synchronous logging"));
+		}
+	}
+
 	if (pid_file[0] != '\0')
 	{
 		check_and_create_pid_file(pid_file);
@@ -530,6 +637,13 @@ main(int argc, char **argv)
 	setup_event_handlers();
 #endif
 
+	/*
+	 * Execute any "event_notification_command" asynchronously, so a slow
+	 * external script can never stall the monitoring loop or delay a
+	 * failover.
+	 */
+	enable_async_notifications();
+
 	start_monitoring();
 
 	logger_shutdown();
@@ -941,30 +1055,117 @@ check_upstream_connection(PGconn **conn, const char *conninfo, PGconn **paired_c
 }
 
 
+/*
+ * Return the pre-built conninfo parameter list for reconnection attempts to
+ * the given node, parsing the node's conninfo string only when it has not
+ * been seen before or has changed (e.g. after a configuration reload);
+ * reconnection retries are then cheap, as each attempt no longer rebuilds
+ * the parameter list from scratch.
+ *
+ * The returned list is owned by the cache and must not be freed by the
+ * caller.
+ */
+t_conninfo_param_list *
+get_reconnect_conninfo_params(t_node_info *node_info)
+{
+	int			i;
+	t_reconnect_params_cache_entry *entry = NULL;
+
+	for (i = 0; i < reconnect_params_cache_used; i++)
+	{
+		if (reconnect_params_cache[i].node_id == node_info->node_id)
+		{
+			entry = &reconnect_params_cache[i];
+
+			/* conninfo unchanged - reuse the cached parameter list */
+			if (strncmp(entry->conninfo, node_info->conninfo, MAXLEN) == 0)
+				return &entry->conninfo_params;
+
+			/* conninfo has changed - rebuild the entry */
+			free_conninfo_params(&entry->conninfo_params);
+			break;
+		}
+	}
+
+	if (entry == NULL)
+	{
+		if (reconnect_params_cache_used < RECONNECT_PARAMS_CACHE_SIZE)
+		{
+			entry = &reconnect_params_cache[reconnect_params_cache_used++];
+		}
+		else
+		{
+			/* cache full - recycle the first entry */
+			entry = &reconnect_params_cache[0];
+			free_conninfo_params(&entry->conninfo_params);
+		}
+	}
+
+	entry->node_id = node_info->node_id;
+	strncpy(entry->conninfo, node_info->conninfo, MAXLEN);
+
+	initialize_conninfo_params(&entry->conninfo_params, false);
+
+	/* we assume by now the conninfo string is parseable */
+	(void) parse_conninfo_string(node_info->conninfo, &entry->conninfo_params, NULL, false);
+
+	/* set some default values if not explicitly provided */
+	param_set_ine(&entry->conninfo_params, "connect_timeout", "2");
+	param_set_ine(&entry->conninfo_params, "fallback_application_name", "repmgr");
+
+	return &entry->conninfo_params;
+}
+
+
+/*
+ * Calculate the sleep time before reconnection attempt "attempt + 1",
+ * applying exponential backoff (doubling per attempt, capped at
+ * RECONNECT_BACKOFF_MAX_MULTIPLIER times "reconnect_interval") plus a
+ * random per-node jitter of up to half the configured interval. This
+ * prevents all standbys from retrying in lockstep and producing a
+ * synchronized connection storm when their primary recovers.
+ */
+int
+reconnect_interval_backoff(int attempt)
+{
+	int			i;
+	int			multiplier = 1;
+	int			interval;
+	int			jitter_range = (config_file_options.reconnect_interval / 2) + 1;
+
+	for (i = 0; i < attempt && multiplier < RECONNECT_BACKOFF_MAX_MULTIPLIER; i++)
+		multiplier *= 2;
+
+	interval = config_file_options.reconnect_interval * multiplier;
+
+	/*
+	 * rand() is seeded at startup; fold in the node ID for per-node
+	 * variation. Reduce each term individually before adding, so the sum
+	 * cannot overflow and produce a negative jitter value.
+	 */
+	interval += (rand() % jitter_range + config_file_options.node_id % jitter_range) % jitter_range;
+
+	return interval;
+}
+
+
 void
 try_reconnect(PGconn **conn, t_node_info *node_info)
 {
 	PGconn	   *our_conn;
-	t_conninfo_param_list conninfo_params = T_CONNINFO_PARAM_LIST_INITIALIZER;
+	t_conninfo_param_list *conninfo_params;
 
 	int			i;
 
 	int			max_attempts = config_file_options.reconnect_attempts;
 
-	initialize_conninfo_params(&conninfo_params, false);
-
-	/* we assume by now the conninfo string is parseable */
-	(void) parse_conninfo_string(node_info->conninfo, &conninfo_params, NULL, false);
-
-	/* set some default values if not explicitly provided */
-	param_set_ine(&conninfo_params, "connect_timeout", "2");
-	param_set_ine(&conninfo_params, "fallback_application_name", "repmgr");
+	conninfo_params = get_reconnect_conninfo_params(node_info);
 
 	for (i = 0; i < max_attempts; i++)
 	{
 		log_info(_("checking state of node %i, %i of %i attempts"),
 				 node_info->node_id, i + 1, max_attempts);
-		if (is_server_available_params(&conninfo_params) == true)
+		if (is_server_available_params(conninfo_params) == true)
 		{
 			log_notice(_("node %i has recovered, reconnecting"), node_info->node_id);
 
@@ -973,12 +1174,10 @@ try_reconnect(PGconn **conn, t_node_info *node_info)
 			 * connection denied due to connection exhaustion, by falling back to
 			 * degraded monitoring (make configurable)
 			 */
-			our_conn = establish_db_connection_by_params(&conninfo_params, false);
+			our_conn = establish_db_connection_by_params(conninfo_params, false);
 
 			if (PQstatus(our_conn) == CONNECTION_OK)
 			{
-				free_conninfo_params(&conninfo_params);
-
 				log_info(_("connection to node %i succeeded"), node_info->node_id);
 
 				if (PQstatus(*conn) == CONNECTION_BAD)
@@ -1032,13 +1231,101 @@ try_reconnect(PGconn **conn, t_node_info *node_info)
 
 	node_info->node_status = NODE_STATUS_DOWN;
 
-	free_conninfo_params(&conninfo_params);
-
 	return;
 }
 
 
 
+/*
+ * Sleep between monitoring loop iterations for up to "seconds" seconds,
+ * waking early if activity (including closure - e.g. a TCP RST from a
+ * crashed upstream) is detected on either of the supplied connections'
+ * sockets, or if a signal is received.
+ *
+ * This keeps failure detection latency well below "monitor_interval_secs"
+ * without busy-polling: the monitoring loop re-checks its connections
+ * immediately after an early wakeup. Either or both connections may be
+ * NULL, in which case this degrades to a plain interruptible sleep.
+ */
+void
+monitoring_sleep(int seconds, PGconn *wake_conn1, PGconn *wake_conn2)
+{
+	fd_set		read_set;
+	struct timeval timeout;
+	int			max_fd = -1;
+	int			rc;
+
+	/* log completion of any finished async notification commands */
+	reap_async_notifications();
+
+	FD_ZERO(&read_set);
+
+	if (wake_conn1 != NULL && PQstatus(wake_conn1) == CONNECTION_OK)
+	{
+		int			sock = PQsocket(wake_conn1);
+
+		if (sock >= 0)
+		{
+			FD_SET(sock, &read_set);
+
+			if (sock > max_fd)
+				max_fd = sock;
+		}
+	}
+
+	if (wake_conn2 != NULL && wake_conn2 != wake_conn1 && PQstatus(wake_conn2) == CONNECTION_OK)
+	{
+		int			sock = PQsocket(wake_conn2);
+
+		if (sock >= 0)
+		{
+			FD_SET(sock, &read_set);
+
+			if (sock > max_fd)
+				max_fd = sock;
+		}
+	}
+
+	timeout.tv_sec = seconds;
+	timeout.tv_usec = 0;
+
+	rc = select(max_fd + 1,
+				max_fd >= 0 ? &read_set : NULL,
+				NULL, NULL,
+				&timeout);
+
+	if (rc < 0)
+	{
+		/*
+		 * EINTR means a signal arrived; return immediately so the caller
+		 * notices e.g. got_SIGHUP without waiting out the interval. Any
+		 * other error shouldn't happen - fall back to a plain sleep to
+		 * avoid a busy loop.
+		 */
+		if (errno != EINTR)
+			sleep(seconds);
+
+		return;
+	}
+
+	if (rc > 0)
+	{
+		/*
+		 * Socket activity detected - consume any pending input (e.g. NOTICE
+		 * messages) so repeated wakeups don't spin, and to ensure a dropped
+		 * connection is flagged as CONNECTION_BAD for the caller to detect.
+		 */
+		if (wake_conn1 != NULL && PQsocket(wake_conn1) >= 0 && FD_ISSET(PQsocket(wake_conn1), &read_set))
+			(void) PQconsumeInput(wake_conn1);
+
+		if (wake_conn2 != NULL && wake_conn2 != wake_conn1 && PQsocket(wake_conn2) >= 0 && FD_ISSET(PQsocket(wake_conn2), &read_set))
+			(void) PQconsumeInput(wake_conn2);
+
+		log_verbose(LOG_DEBUG, "monitoring_sleep(): woken early by connection socket activity");
+	}
+}
+
+
 int
 calculate_elapsed(instr_time start_time)
 {
@@ -1052,6 +1339,391 @@ calculate_elapsed(instr_time start_time)
 }
 
 
+/*
+ * Record the elapsed time of a monitoring/failover phase in the in-process
+ * histogram for that phase. Bucket boundaries double from 1ms upwards; the
+ * final bucket is unbounded.
+ */
+void
+record_phase_timing(RepmgrdTimingPhase phase, instr_time start_time)
+{
+	t_phase_timing *timing = &phase_timings[phase];
+	instr_time	elapsed;
+	long		elapsed_ms;
+	int			bucket = 0;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, start_time);
+
+	elapsed_ms = (long) INSTR_TIME_GET_MILLISEC(elapsed);
+
+	timing->count++;
+	timing->total_ms += elapsed_ms;
+
+	if (elapsed_ms > timing->max_ms)
+		timing->max_ms = elapsed_ms;
+
+	timing->last_ms = elapsed_ms;
+
+	while (bucket < TIMING_HISTOGRAM_BUCKETS - 1 && elapsed_ms >= (1L << bucket))
+		bucket++;
+
+	timing->buckets[bucket]++;
+
+	phase_timings_updated = true;
+
+	/*
+	 * Election and failover timings are rare and of immediate interest
+	 * (e.g. to the failover benchmark harness), so skip the publication
+	 * interval for them.
+	 */
+	if (phase == TIMING_PHASE_ELECTION || phase == TIMING_PHASE_FAILOVER)
+		phase_timings_last_published = 0;
+}
+
+
+/*
+ * Format the phase timing histograms as one line per phase; phases with no
+ * recorded timings are omitted, as are empty histogram buckets.
+ */
+void
+format_phase_timings(PQExpBufferData *buf)
+{
+	int			i, j;
+
+	for (i = 0; i < TIMING_PHASE_COUNT; i++)
+	{
+		t_phase_timing *timing = &phase_timings[i];
+
+		if (timing->count == 0)
+			continue;
+
+		if (buf->len > 0)
+			appendPQExpBufferChar(buf, '\n');
+
+		appendPQExpBuffer(buf,
+						  "%s: count=%li total_ms=%li avg_ms=%li max_ms=%li",
+						  phase_timing_names[i],
+						  timing->count,
+						  timing->total_ms,
+						  timing->total_ms / timing->count,
+						  timing->max_ms);
+
+		for (j = 0; j < TIMING_HISTOGRAM_BUCKETS; j++)
+		{
+			if (timing->buckets[j] == 0)
+				continue;
+
+			if (j == TIMING_HISTOGRAM_BUCKETS - 1)
+				appendPQExpBuffer(buf, " >=%ldms=%li",
+								  1L << (j - 1),
+								  timing->buckets[j]);
+			else
+				appendPQExpBuffer(buf, " <%ldms=%li",
+								  1L << j,
+								  timing->buckets[j]);
+		}
+	}
+}
+
+
+/*
+ * Push the phase timing histograms to the repmgr extension's shared memory,
+ * from where they can be retrieved with "repmgr daemon status --timings".
+ *
+ * To keep the overhead negligible, this is a no-op unless new timings have
+ * been recorded and at least TIMING_PUBLISH_INTERVAL seconds have passed
+ * since the last publication.
+ */
+void
+publish_phase_timings(PGconn *conn)
+{
+	PQExpBufferData timings;
+	time_t		now = time(NULL);
+
+	if (phase_timings_updated == false)
+		return;
+
+	if (now - phase_timings_last_published < TIMING_PUBLISH_INTERVAL)
+		return;
+
+	if (PQstatus(conn) != CONNECTION_OK)
+		return;
+
+	initPQExpBuffer(&timings);
+
+	format_phase_timings(&timings);
+
+	repmgrd_set_timings(conn, timings.data);
+
+	termPQExpBuffer(&timings);
+
+	phase_timings_updated = false;
+	phase_timings_last_published = now;
+}
+
+
+/*
+ * Store the most recent replication info sample for inclusion in the
+ * metrics snapshot, and append it to the LSN sample ring buffer.
+ */
+void
+update_replication_metrics(ReplInfo *replication_info)
+{
+	LSNSample  *sample;
+
+	memcpy(&metrics_replication_info, replication_info, sizeof(ReplInfo));
+	metrics_replication_info_valid = true;
+
+	if (replication_info->last_wal_replay_lsn == InvalidXLogRecPtr)
+		return;
+
+	/*
+	 * A replay position behind the previous sample means the node was
+	 * rewound or reattached elsewhere; discard the accumulated history
+	 * rather than derive rates across the discontinuity.
+	 */
+	if (lsn_sample_count > 0)
+	{
+		int			newest = (lsn_sample_next + LSN_SAMPLE_RING_SIZE - 1) % LSN_SAMPLE_RING_SIZE;
+
+		if (replication_info->last_wal_replay_lsn < lsn_sample_ring[newest].replay_lsn)
+		{
+			lsn_sample_count = 0;
+			lsn_sample_next = 0;
+		}
+	}
+
+	sample = &lsn_sample_ring[lsn_sample_next];
+
+	sample->sample_time = time(NULL);
+	sample->receive_lsn = replication_info->last_wal_receive_lsn;
+	sample->replay_lsn = replication_info->last_wal_replay_lsn;
+
+	lsn_sample_next = (lsn_sample_next + 1) % LSN_SAMPLE_RING_SIZE;
+
+	if (lsn_sample_count < LSN_SAMPLE_RING_SIZE)
+		lsn_sample_count++;
+}
+
+
+/*
+ * Derive throughput and lag trend statistics from the LSN sample ring
+ * buffer; returns false if fewer than two samples are available.
+ *
+ * Rates are calculated over the whole buffered window (oldest to newest
+ * sample), which smooths out per-tick jitter. The catch-up estimate is
+ * the time needed to replay the current receive/replay gap at the rate
+ * by which replay is currently outpacing receipt; -1 indicates the
+ * standby is not closing the gap at current rates.
+ */
+static bool
+calculate_replication_lag_stats(ReplicationLagStats *stats)
+{
+	LSNSample  *oldest;
+	LSNSample  *newest;
+
+	if (lsn_sample_count < 2)
+		return false;
+
+	if (lsn_sample_count < LSN_SAMPLE_RING_SIZE)
+		oldest = &lsn_sample_ring[0];
+	else
+		oldest = &lsn_sample_ring[lsn_sample_next];
+
+	newest = &lsn_sample_ring[(lsn_sample_next + LSN_SAMPLE_RING_SIZE - 1) % LSN_SAMPLE_RING_SIZE];
+
+	stats->samples = lsn_sample_count;
+	stats->window_seconds = (long) difftime(newest->sample_time, oldest->sample_time);
+
+	if (stats->window_seconds <= 0)
+		return false;
+
+	stats->apply_rate = (long long) (newest->replay_lsn - oldest->replay_lsn) / stats->window_seconds;
+
+	if (newest->receive_lsn != InvalidXLogRecPtr
+		&& oldest->receive_lsn != InvalidXLogRecPtr
+		&& newest->receive_lsn >= oldest->receive_lsn)
+	{
+		stats->receive_rate = (long long) (newest->receive_lsn - oldest->receive_lsn) / stats->window_seconds;
+	}
+	else
+	{
+		stats->receive_rate = 0;
+	}
+
+	if (newest->receive_lsn != InvalidXLogRecPtr
+		&& newest->receive_lsn >= newest->replay_lsn)
+	{
+		stats->lag_bytes = (long long) (newest->receive_lsn - newest->replay_lsn);
+	}
+	else
+	{
+		stats->lag_bytes = 0;
+	}
+
+	if (stats->lag_bytes == 0)
+		stats->estimated_catchup_seconds = 0;
+	else if (stats->apply_rate > stats->receive_rate)
+		stats->estimated_catchup_seconds = stats->lag_bytes / (stats->apply_rate - stats->receive_rate);
+	else
+		stats->estimated_catchup_seconds = -1;
+
+	return true;
+}
+
+
+/*
+ * Push the current replication lag trend statistics to the repmgr
+ * extension's shared memory, from where "repmgr node check
+ * --replication-lag" can retrieve them.
+ *
+ * The statistics are derived entirely from the samples already
+ * collected by update_replication_metrics(), so beyond the one
+ * lightweight function call here no additional monitoring queries
+ * are executed.
+ */
+void
+publish_replication_lag_stats(PGconn *conn)
+{
+	ReplicationLagStats stats;
+	PQExpBufferData buf;
+
+	if (PQstatus(conn) != CONNECTION_OK)
+		return;
+
+	if (calculate_replication_lag_stats(&stats) == false)
+		return;
+
+	initPQExpBuffer(&buf);
+
+	appendPQExpBuffer(&buf,
+					  "updated=%li window_seconds=%li samples=%i receive_rate=%lld apply_rate=%lld lag_bytes=%lld estimated_catchup_seconds=%lld",
+					  (long) time(NULL),
+					  stats.window_seconds,
+					  stats.samples,
+					  stats.receive_rate,
+					  stats.apply_rate,
+					  stats.lag_bytes,
+					  stats.estimated_catchup_seconds);
+
+	repmgrd_set_lag_stats(conn, buf.data);
+
+	termPQExpBuffer(&buf);
+}
+
+
+/*
+ * Store the outcome of the most recent election for inclusion in the
+ * metrics snapshot.
+ */
+void
+update_election_metrics(const char *election_result)
+{
+	maxlen_snprintf(metrics_last_election_result, "%s", election_result);
+}
+
+
+/*
+ * Write the current metrics snapshot to "repmgrd_metrics_file", so
+ * monitoring agents can scrape repmgrd state without connecting to
+ * PostgreSQL. The snapshot is written to a temporary file and renamed
+ * into place, so scrapers never see a partially-written file.
+ *
+ * No-op if "repmgrd_metrics_file" is not configured.
+ */
+void
+write_metrics_snapshot(void)
+{
+	PQExpBufferData buf;
+	char		tmp_filename[MAXPGPATH + 8];
+	FILE	   *file = NULL;
+	int			degraded_seconds = 0;
+	ReplicationLagStats lag_stats;
+
+	if (config_file_options.repmgrd_metrics_file[0] == '\0')
+		return;
+
+	if (monitoring_state == MS_DEGRADED)
+		degraded_seconds = calculate_elapsed(degraded_monitoring_start);
+
+	initPQExpBuffer(&buf);
+
+	appendPQExpBuffer(&buf, "updated=%li\n", (long) time(NULL));
+	appendPQExpBuffer(&buf, "node_id=%i\n", local_node_info.node_id);
+	appendPQExpBuffer(&buf, "monitoring_state=%s\n", print_monitoring_state(monitoring_state));
+	appendPQExpBuffer(&buf, "degraded_monitoring_seconds=%i\n", degraded_seconds);
+	appendPQExpBuffer(&buf, "upstream_node_id=%i\n", local_node_info.upstream_node_id);
+	appendPQExpBuffer(&buf, "last_election_result=%s\n", metrics_last_election_result);
+
+	if (metrics_replication_info_valid == true)
+	{
+		appendPQExpBuffer(&buf, "timeline_id=%i\n", (int) metrics_replication_info.timeline_id);
+		appendPQExpBuffer(&buf, "last_wal_receive_lsn=%X/%X\n",
+						  format_lsn(metrics_replication_info.last_wal_receive_lsn));
+		appendPQExpBuffer(&buf, "last_wal_replay_lsn=%X/%X\n",
+						  format_lsn(metrics_replication_info.last_wal_replay_lsn));
+		appendPQExpBuffer(&buf, "replication_lag_seconds=%i\n",
+						  metrics_replication_info.replication_lag_time);
+		appendPQExpBuffer(&buf, "receiving_streamed_wal=%i\n",
+						  metrics_replication_info.receiving_streamed_wal ? 1 : 0);
+		appendPQExpBuffer(&buf, "wal_replay_paused=%i\n",
+						  metrics_replication_info.wal_replay_paused ? 1 : 0);
+		appendPQExpBuffer(&buf, "upstream_last_seen=%i\n",
+						  metrics_replication_info.upstream_last_seen);
+	}
+
+	if (calculate_replication_lag_stats(&lag_stats) == true)
+	{
+		appendPQExpBuffer(&buf, "receive_rate_bytes_sec=%lld\n",
+						  lag_stats.receive_rate);
+		appendPQExpBuffer(&buf, "apply_rate_bytes_sec=%lld\n",
+						  lag_stats.apply_rate);
+		appendPQExpBuffer(&buf, "estimated_catchup_seconds=%lld\n",
+						  lag_stats.estimated_catchup_seconds);
+	}
+
+	appendPQExpBuffer(&buf, "primary_monitoring_last_ms=%li\n",
+					  phase_timings[TIMING_PHASE_PRIMARY_MONITORING].last_ms);
+	appendPQExpBuffer(&buf, "standby_monitoring_last_ms=%li\n",
+					  phase_timings[TIMING_PHASE_STANDBY_MONITORING].last_ms);
+
+	snprintf(tmp_filename, sizeof(tmp_filename),
+			 "%s.tmp", config_file_options.repmgrd_metrics_file);
+
+	file = fopen(tmp_filename, "w");
+
+	if (file == NULL)
+	{
+		log_warning(_("unable to open metrics file \"%s\" for writing"), tmp_filename);
+		log_detail("%s", strerror(errno));
+		termPQExpBuffer(&buf);
+		return;
+	}
+
+	if (fwrite(buf.data, strlen(buf.data), 1, file) != 1)
+	{
+		log_warning(_("unable to write to metrics file \"%s\""), tmp_filename);
+		fclose(file);
+		unlink(tmp_filename);
+		termPQExpBuffer(&buf);
+		return;
+	}
+
+	fclose(file);
+
+	if (rename(tmp_filename, config_file_options.repmgrd_metrics_file) != 0)
+	{
+		log_warning(_("unable to rename \"%s\" to \"%s\""),
+					tmp_filename, config_file_options.repmgrd_metrics_file);
+		log_detail("%s", strerror(errno));
+		unlink(tmp_filename);
+	}
+
+	termPQExpBuffer(&buf);
+}
+
+
 const char *
 print_monitoring_state(MonitoringState monitoring_state)
 {
@@ -13,6 +13,20 @@
 #define OPT_NO_PID_FILE                  1000
 #define OPT_DAEMONIZE                    1001
 
+/*
+ * Monitoring/failover phases instrumented with timing histograms
+ * (see record_phase_timing() etc. in repmgrd.c)
+ */
+typedef enum
+{
+	TIMING_PHASE_PRIMARY_MONITORING = 0,
+	TIMING_PHASE_STANDBY_MONITORING,
+	TIMING_PHASE_ELECTION,
+	TIMING_PHASE_FAILOVER
+} RepmgrdTimingPhase;
+
+#define TIMING_PHASE_COUNT 4
+
 extern volatile sig_atomic_t got_SIGHUP;
 extern MonitoringState monitoring_state;
 extern instr_time degraded_monitoring_start;
@@ -23,8 +37,21 @@ extern bool startup_event_logged;
 extern char pid_file[MAXPGPATH];
 
 bool		check_upstream_connection(PGconn **conn, const char *conninfo, PGconn **paired_conn);
+t_conninfo_param_list *get_reconnect_conninfo_params(t_node_info *node_info);
+int			reconnect_interval_backoff(int attempt);
 void		try_reconnect(PGconn **conn, t_node_info *node_info);
 
+void		monitoring_sleep(int seconds, PGconn *wake_conn1, PGconn *wake_conn2);
+
+void		record_phase_timing(RepmgrdTimingPhase phase, instr_time start_time);
+void		format_phase_timings(PQExpBufferData *buf);
+void		publish_phase_timings(PGconn *conn);
+
+void		update_replication_metrics(ReplInfo *replication_info);
+void		publish_replication_lag_stats(PGconn *conn);
+void		update_election_metrics(const char *election_result);
+void		write_metrics_snapshot(void);
+
 int			calculate_elapsed(instr_time start_time);
 const char *print_monitoring_state(MonitoringState monitoring_state);
 
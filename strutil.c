@@ -451,6 +451,51 @@ escape_double_quotes(char *string, PQExpBufferData *out)
 }
 
 
+/*
+ * Append the provided string to the output buffer as a JSON string,
+ * including the enclosing double quotes.
+ */
+void
+append_json_string(PQExpBufferData *out, const char *string)
+{
+	const char *ptr;
+
+	appendPQExpBufferChar(out, '"');
+
+	for (ptr = string; *ptr; ptr++)
+	{
+		switch (*ptr)
+		{
+			case '"':
+				appendPQExpBufferStr(out, "\\\"");
+				break;
+			case '\\':
+				appendPQExpBufferStr(out, "\\\\");
+				break;
+			case '\n':
+				appendPQExpBufferStr(out, "\\n");
+				break;
+			case '\r':
+				appendPQExpBufferStr(out, "\\r");
+				break;
+			case '\t':
+				appendPQExpBufferStr(out, "\\t");
+				break;
+			default:
+				if ((unsigned char) *ptr < 0x20)
+					appendPQExpBuffer(out, "\\u%04x", (unsigned char) *ptr);
+				else
+					appendPQExpBufferChar(out, *ptr);
+				break;
+		}
+	}
+
+	appendPQExpBufferChar(out, '"');
+
+	return;
+}
+
+
 char *
 string_skip_prefix(const char *prefix, char *string)
 {
@@ -567,3 +612,135 @@ format_bool(bool value)
 {
 	return value == true ? "true" : "false";
 }
+
+
+/*
+ * Arena allocator
+ *
+ * Allocations are served by bumping a pointer within fixed-size blocks;
+ * arena_reset() makes all blocks available for reuse without returning
+ * them to the heap, so steady-state allocation cycles are malloc-free.
+ * Requests larger than the block size are served from a dedicated block.
+ */
+
+static MemoryArenaBlock *
+_arena_new_block(size_t size)
+{
+	MemoryArenaBlock *block = pg_malloc0(sizeof(MemoryArenaBlock));
+
+	block->size = size;
+	block->used = 0;
+	block->data = pg_malloc(size);
+	block->next = NULL;
+
+	return block;
+}
+
+
+void
+arena_init(MemoryArena *arena, size_t block_size)
+{
+	arena->blocks = NULL;
+	arena->current = NULL;
+	arena->block_size = block_size > 0 ? block_size : ARENA_BLOCK_SIZE;
+}
+
+
+void *
+arena_alloc(MemoryArena *arena, size_t size)
+{
+	void	   *ptr = NULL;
+
+	if (arena->block_size == 0)
+		arena->block_size = ARENA_BLOCK_SIZE;
+
+	/* keep allocations aligned for any object type */
+	size = MAXALIGN(size);
+
+	/* advance to (or append) a block with enough free space */
+	while (arena->current == NULL || arena->current->size - arena->current->used < size)
+	{
+		if (arena->current == NULL)
+		{
+			if (arena->blocks == NULL)
+				arena->blocks = _arena_new_block(Max(size, arena->block_size));
+
+			arena->current = arena->blocks;
+		}
+		else if (arena->current->next != NULL)
+		{
+			arena->current = arena->current->next;
+		}
+		else
+		{
+			arena->current->next = _arena_new_block(Max(size, arena->block_size));
+			arena->current = arena->current->next;
+		}
+	}
+
+	ptr = arena->current->data + arena->current->used;
+	arena->current->used += size;
+
+	return ptr;
+}
+
+
+void *
+arena_alloc0(MemoryArena *arena, size_t size)
+{
+	void	   *ptr = arena_alloc(arena, size);
+
+	memset(ptr, 0, size);
+
+	return ptr;
+}
+
+
+char *
+arena_strdup(MemoryArena *arena, const char *string)
+{
+	size_t		len = strlen(string) + 1;
+	char	   *copy = arena_alloc(arena, len);
+
+	memcpy(copy, string, len);
+
+	return copy;
+}
+
+
+/*
+ * Make the arena's memory available for reuse; the blocks themselves are
+ * retained.
+ */
+void
+arena_reset(MemoryArena *arena)
+{
+	MemoryArenaBlock *block = NULL;
+
+	for (block = arena->blocks; block; block = block->next)
+		block->used = 0;
+
+	arena->current = arena->blocks;
+}
+
+
+/*
+ * Return all of the arena's memory to the heap.
+ */
+void
+arena_destroy(MemoryArena *arena)
+{
+	MemoryArenaBlock *block = arena->blocks;
+	MemoryArenaBlock *next_block = NULL;
+
+	while (block != NULL)
+	{
+		next_block = block->next;
+		pg_free(block->data);
+		pg_free(block);
+		block = next_block;
+	}
+
+	arena->blocks = NULL;
+	arena->current = NULL;
+}
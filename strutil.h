@@ -52,7 +52,8 @@ typedef enum
 	OM_TEXT,
 	OM_CSV,
 	OM_NAGIOS,
-	OM_OPTFORMAT
+	OM_OPTFORMAT,
+	OM_JSON_LINES
 } OutputMode;
 
 typedef struct ItemListCell
@@ -82,6 +83,36 @@ typedef struct KeyValueList
 } KeyValueList;
 
 
+/*
+ * Simple arena allocator for transient, bulk-freed allocations; memory is
+ * claimed from fixed-size blocks and returned by resetting the whole arena,
+ * so repeated allocation cycles (e.g. one per repmgrd monitoring loop
+ * iteration) cause no malloc/free traffic after the first cycle.
+ */
+
+#define ARENA_BLOCK_SIZE 8192
+
+typedef struct MemoryArenaBlock
+{
+	struct MemoryArenaBlock *next;
+	size_t		size;
+	size_t		used;
+	char	   *data;
+} MemoryArenaBlock;
+
+typedef struct MemoryArena
+{
+	MemoryArenaBlock *blocks;	/* all blocks, in allocation order */
+	MemoryArenaBlock *current;	/* block allocations are served from */
+	size_t		block_size;
+} MemoryArena;
+
+#define T_MEMORY_ARENA_INITIALIZER { \
+	NULL, \
+	NULL, \
+	ARENA_BLOCK_SIZE \
+}
+
 typedef struct CheckStatusListCell
 {
 	struct CheckStatusListCell *next;
@@ -151,6 +182,7 @@ extern char *escape_recovery_conf_value(const char *src);
 extern char *escape_string(PGconn *conn, const char *string);
 
 extern void escape_double_quotes(char *string, PQExpBufferData *out);
+extern void append_json_string(PQExpBufferData *out, const char *string);
 
 extern void
 append_where_clause(PQExpBufferData *where_clause, const char *clause,...)
@@ -168,4 +200,11 @@ extern void
 
 extern const char *format_bool(bool value);
 
+extern void arena_init(MemoryArena *arena, size_t block_size);
+extern void *arena_alloc(MemoryArena *arena, size_t size);
+extern void *arena_alloc0(MemoryArena *arena, size_t size);
+extern char *arena_strdup(MemoryArena *arena, const char *string);
+extern void arena_reset(MemoryArena *arena);
+extern void arena_destroy(MemoryArena *arena);
+
 #endif							/* _STRUTIL_H_ */
@@ -19,12 +19,51 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
 #include <signal.h>
+#include <sys/select.h>
+#include <sys/wait.h>
 
 #include "repmgr.h"
 
 static bool _local_command(const char *command, PQExpBufferData *outputbuf, bool simple, int *return_value);
 
+/*
+ * Multiplexed SSH sessions (see ssh_session_begin()); entries are matched
+ * by host and user.
+ */
+typedef struct
+{
+	bool		active;
+	char		host[MAXLEN];
+	char		user[MAXLEN];
+	char		control_path[MAXPGPATH];
+} t_ssh_session;
+
+static t_ssh_session ssh_sessions[MAX_SSH_SESSIONS];
+
+/*
+ * Private directory holding the control sockets, created on first use;
+ * see ssh_session_begin().
+ */
+static char ssh_control_dir[MAXPGPATH] = "";
+
+static t_ssh_session *_find_ssh_session(const char *host, const char *user);
+
+/*
+ * In-flight asynchronous notification commands (see
+ * execute_notification_command()); only used when async execution has
+ * been enabled with enable_async_notifications().
+ */
+typedef struct
+{
+	pid_t		pid;
+	char		event[MAXLEN];
+} t_async_notification;
+
+static t_async_notification async_notifications[NOTIFICATION_QUEUE_MAX];
+static bool async_notification_enabled = false;
+
 
 /*
  * Execute a command locally. "outputbuf" should either be an
@@ -176,6 +215,7 @@ void
 make_remote_command(const char *host, const char *user, const char *command, const char *ssh_options, PQExpBufferData *ssh_command)
 {
 	PQExpBufferData ssh_host;
+	t_ssh_session *session = NULL;
 
 	initPQExpBuffer(&ssh_host);
 
@@ -187,8 +227,21 @@ make_remote_command(const char *host, const char *user, const char *command, con
 	appendPQExpBufferStr(&ssh_host, host);
 
 
+	appendPQExpBufferStr(ssh_command,
+						 "ssh -o Batchmode=yes ");
+
+	/* reuse a multiplexed session for this host, if one exists */
+	session = _find_ssh_session(host, user);
+
+	if (session != NULL)
+	{
+		appendPQExpBuffer(ssh_command,
+						  "-o ControlPath=%s ",
+						  session->control_path);
+	}
+
 	appendPQExpBuffer(ssh_command,
-					  "ssh -o Batchmode=yes %s %s %s",
+					  "%s %s %s",
 					  ssh_options,
 					  ssh_host.data,
 					  command);
@@ -198,6 +251,452 @@ make_remote_command(const char *host, const char *user, const char *command, con
 }
 
 
+static t_ssh_session *
+_find_ssh_session(const char *host, const char *user)
+{
+	int			i;
+
+	for (i = 0; i < MAX_SSH_SESSIONS; i++)
+	{
+		if (ssh_sessions[i].active == true
+			&& strncmp(ssh_sessions[i].host, host, MAXLEN) == 0
+			&& strncmp(ssh_sessions[i].user, user, MAXLEN) == 0)
+		{
+			return &ssh_sessions[i];
+		}
+	}
+
+	return NULL;
+}
+
+
+/*
+ * Establish a multiplexed SSH control connection ("ControlMaster") to the
+ * given host. While the session is active, commands generated by
+ * make_remote_command() for that host will reuse the control connection,
+ * avoiding the overhead of a full SSH handshake for each command; this
+ * makes a noticeable difference to multi-step operations such as
+ * "standby switchover", which execute a dozen or more remote commands in
+ * succession.
+ *
+ * Sessions should be terminated with ssh_session_end_all(); as a backstop
+ * (e.g. if the operation exits early due to an error) the control
+ * connection will shut itself down after 60 seconds of inactivity.
+ *
+ * Returns true if the session was established (or already exists);
+ * on failure, subsequent remote commands will simply fall back to
+ * individual SSH connections.
+ */
+bool
+ssh_session_begin(const char *host, const char *user, const char *ssh_options)
+{
+	PQExpBufferData ssh_command;
+	t_ssh_session *session = NULL;
+	int			i;
+	bool		success;
+
+	if (_find_ssh_session(host, user) != NULL)
+		return true;
+
+	for (i = 0; i < MAX_SSH_SESSIONS; i++)
+	{
+		if (ssh_sessions[i].active == false)
+		{
+			session = &ssh_sessions[i];
+			break;
+		}
+	}
+
+	if (session == NULL)
+	{
+		log_verbose(LOG_DEBUG, "ssh_session_begin(): no free session slots");
+		return false;
+	}
+
+	/*
+	 * Create the directory holding the control sockets on first use. A
+	 * freshly created mode 0700 directory with an unpredictable name
+	 * ensures another local user cannot pre-create or substitute a socket
+	 * at a known path and have our commands multiplex through it.
+	 */
+	if (ssh_control_dir[0] == '\0')
+	{
+		char		dir_template[] = "/tmp/.repmgr-ssh-XXXXXX";
+
+		if (mkdtemp(dir_template) == NULL)
+		{
+			log_warning(_("unable to create SSH control socket directory"));
+			log_detail("%s", strerror(errno));
+			return false;
+		}
+
+		strncpy(ssh_control_dir, dir_template, MAXPGPATH);
+	}
+
+	strncpy(session->host, host, MAXLEN);
+	strncpy(session->user, user, MAXLEN);
+	snprintf(session->control_path, MAXPGPATH,
+			 "%s/%i",
+			 ssh_control_dir, i);
+
+	initPQExpBuffer(&ssh_command);
+
+	appendPQExpBuffer(&ssh_command,
+					  "ssh -o Batchmode=yes %s -o ControlMaster=yes -o ControlPath=%s -o ControlPersist=60 -fN ",
+					  ssh_options,
+					  session->control_path);
+
+	if (*user != '\0')
+	{
+		appendPQExpBuffer(&ssh_command, "%s@", user);
+	}
+
+	appendPQExpBufferStr(&ssh_command, host);
+
+	log_verbose(LOG_DEBUG, "ssh_session_begin():\n  %s", ssh_command.data);
+
+	success = local_command(ssh_command.data, NULL);
+
+	termPQExpBuffer(&ssh_command);
+
+	if (success == false)
+	{
+		log_warning(_("unable to establish SSH control connection to host \"%s\""),
+					host);
+		return false;
+	}
+
+	session->active = true;
+
+	log_verbose(LOG_INFO, "SSH control connection to host \"%s\" established", host);
+
+	return true;
+}
+
+
+/*
+ * Terminate all SSH control connections established with ssh_session_begin().
+ */
+void
+ssh_session_end_all(void)
+{
+	int			i;
+
+	for (i = 0; i < MAX_SSH_SESSIONS; i++)
+	{
+		PQExpBufferData ssh_command;
+
+		if (ssh_sessions[i].active == false)
+			continue;
+
+		initPQExpBuffer(&ssh_command);
+
+		appendPQExpBuffer(&ssh_command,
+						  "ssh -o ControlPath=%s -O exit ",
+						  ssh_sessions[i].control_path);
+
+		if (ssh_sessions[i].user[0] != '\0')
+		{
+			appendPQExpBuffer(&ssh_command, "%s@", ssh_sessions[i].user);
+		}
+
+		appendPQExpBuffer(&ssh_command,
+						  "%s >/dev/null 2>&1",
+						  ssh_sessions[i].host);
+
+		log_verbose(LOG_DEBUG, "ssh_session_end_all():\n  %s", ssh_command.data);
+
+		(void) local_command(ssh_command.data, NULL);
+
+		termPQExpBuffer(&ssh_command);
+
+		/* the control master removes its socket on exit; this is a backstop */
+		(void) unlink(ssh_sessions[i].control_path);
+
+		ssh_sessions[i].active = false;
+	}
+
+	if (ssh_control_dir[0] != '\0')
+	{
+		/*
+		 * Best-effort: this will fail if a control master is still
+		 * shutting down, in which case the empty directory is left behind.
+		 */
+		(void) rmdir(ssh_control_dir);
+
+		ssh_control_dir[0] = '\0';
+	}
+}
+
+
+/*
+ * Execute a batch of commands concurrently, with at most "max_workers"
+ * running at any one time.
+ *
+ * Each entry in "commands" must have its "command" buffer initialised with
+ * the complete command to execute (for remote execution, the caller should
+ * wrap the command with make_remote_command() first). On return, each
+ * entry's "output" buffer contains whatever the command wrote to stdout,
+ * and "success" indicates whether it exited cleanly; it is the caller's
+ * responsibility to free both buffers.
+ *
+ * Returns false if any command could not be executed or exited with a
+ * non-zero status.
+ *
+ * This enables operations which probe multiple nodes (e.g. "cluster matrix"
+ * and "cluster crosscheck") to complete in roughly the time taken by the
+ * slowest single probe, rather than the sum of all probes.
+ */
+bool
+execute_parallel_commands(t_parallel_command *commands, int command_count, int max_workers)
+{
+	FILE	  **fps = NULL;
+	int			next_command = 0;
+	int			running_count = 0;
+	int			finished_count = 0;
+	int			i;
+	bool		overall_success = true;
+
+	if (command_count == 0)
+		return true;
+
+	if (max_workers < 1)
+		max_workers = 1;
+
+	fps = (FILE **) pg_malloc0(sizeof(FILE *) * command_count);
+
+	while (finished_count < command_count)
+	{
+		fd_set		read_set;
+		int			max_fd = -1;
+
+		/* top up the worker pool */
+		while (running_count < max_workers && next_command < command_count)
+		{
+			int			ix = next_command++;
+
+			initPQExpBuffer(&commands[ix].output);
+			commands[ix].success = false;
+
+			log_verbose(LOG_DEBUG, "execute_parallel_commands(): executing:\n  %s",
+						commands[ix].command.data);
+
+			fps[ix] = popen(commands[ix].command.data, "r");
+
+			if (fps[ix] == NULL)
+			{
+				log_error(_("unable to execute command:\n  %s"),
+						  commands[ix].command.data);
+				finished_count++;
+				overall_success = false;
+				continue;
+			}
+
+			running_count++;
+		}
+
+		if (running_count == 0)
+			break;
+
+		FD_ZERO(&read_set);
+
+		for (i = 0; i < next_command; i++)
+		{
+			if (fps[i] != NULL)
+			{
+				int			fd = fileno(fps[i]);
+
+				FD_SET(fd, &read_set);
+
+				if (fd > max_fd)
+					max_fd = fd;
+			}
+		}
+
+		if (select(max_fd + 1, &read_set, NULL, NULL, NULL) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+
+			log_error(_("select() failed in execute_parallel_commands():\n  %s"),
+					  strerror(errno));
+			overall_success = false;
+			break;
+		}
+
+		for (i = 0; i < next_command; i++)
+		{
+			char		output[MAXLEN];
+			ssize_t		bytes_read;
+
+			if (fps[i] == NULL || !FD_ISSET(fileno(fps[i]), &read_set))
+				continue;
+
+			bytes_read = read(fileno(fps[i]), output, MAXLEN - 1);
+
+			if (bytes_read > 0)
+			{
+				output[bytes_read] = '\0';
+				appendPQExpBufferStr(&commands[i].output, output);
+			}
+			else
+			{
+				/* EOF (or read error) - the command has completed */
+				int			retval = pclose(fps[i]);
+
+				fps[i] = NULL;
+				running_count--;
+				finished_count++;
+
+				commands[i].success = (WEXITSTATUS(retval) == 0 || WEXITSTATUS(retval) == 141) ? true : false;
+
+				log_verbose(LOG_DEBUG, "execute_parallel_commands(): result of command %i was %i",
+							commands[i].id, WEXITSTATUS(retval));
+
+				if (commands[i].success == false)
+					overall_success = false;
+			}
+		}
+	}
+
+	/* clean up any commands still running after an error */
+	for (i = 0; i < next_command; i++)
+	{
+		if (fps[i] != NULL)
+		{
+			pclose(fps[i]);
+			fps[i] = NULL;
+		}
+	}
+
+	pg_free(fps);
+
+	return overall_success;
+}
+
+
+/*
+ * Enable asynchronous execution of event notification commands.
+ *
+ * This is called by repmgrd at startup, so that a slow or hung
+ * "event_notification_command" (e.g. a webhook post) can never stall the
+ * monitoring loop or delay a failover. The repmgr client executes
+ * notification commands synchronously, as it may exit immediately after
+ * generating an event.
+ */
+void
+enable_async_notifications(void)
+{
+	async_notification_enabled = true;
+}
+
+
+/*
+ * Collect any asynchronous notification commands which have finished,
+ * logging their completion status.
+ */
+void
+reap_async_notifications(void)
+{
+	int			i;
+
+	for (i = 0; i < NOTIFICATION_QUEUE_MAX; i++)
+	{
+		int			status = 0;
+		pid_t		pid;
+
+		if (async_notifications[i].pid == 0)
+			continue;
+
+		pid = waitpid(async_notifications[i].pid, &status, WNOHANG);
+
+		if (pid == 0)
+			continue;
+
+		if (pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0)
+		{
+			log_verbose(LOG_DEBUG, "notification command for event \"%s\" completed",
+						async_notifications[i].event);
+		}
+		else
+		{
+			log_warning(_("notification command for event \"%s\" exited with status %i"),
+						async_notifications[i].event,
+						WEXITSTATUS(status));
+		}
+
+		async_notifications[i].pid = 0;
+	}
+}
+
+
+/*
+ * Execute an event notification command; asynchronously if enabled (see
+ * enable_async_notifications()), otherwise synchronously via system().
+ *
+ * In asynchronous mode a "true" return value indicates the command was
+ * dispatched successfully; its completion status is logged later by
+ * reap_async_notifications(). At most NOTIFICATION_QUEUE_MAX commands
+ * run concurrently; if the queue is full, execution falls back to
+ * synchronous so no notification is ever dropped.
+ */
+bool
+execute_notification_command(const char *command, const char *event)
+{
+	int			i;
+	int			slot = -1;
+	pid_t		pid;
+
+	if (async_notification_enabled == true)
+	{
+		/* collect any finished commands, freeing up queue slots */
+		reap_async_notifications();
+
+		for (i = 0; i < NOTIFICATION_QUEUE_MAX; i++)
+		{
+			if (async_notifications[i].pid == 0)
+			{
+				slot = i;
+				break;
+			}
+		}
+
+		if (slot == -1)
+		{
+			log_warning(_("notification queue full, executing notification command synchronously"));
+		}
+		else
+		{
+			pid = fork();
+
+			if (pid == 0)
+			{
+				/* child */
+				execl("/bin/sh", "sh", "-c", command, (char *) NULL);
+				_exit(127);
+			}
+
+			if (pid > 0)
+			{
+				async_notifications[slot].pid = pid;
+				snprintf(async_notifications[slot].event, MAXLEN, "%s", event);
+
+				log_verbose(LOG_DEBUG, "notification command for event \"%s\" dispatched with pid %i",
+							event, (int) pid);
+
+				return true;
+			}
+
+			/* fork() failed - fall through to synchronous execution */
+			log_warning(_("unable to fork notification command:\n  %s"),
+						strerror(errno));
+		}
+	}
+
+	return (system(command) == 0) ? true : false;
+}
+
+
 pid_t
 disable_wal_receiver(PGconn *conn)
 {
@@ -19,6 +19,28 @@
 #ifndef _SYSUTILS_H_
 #define _SYSUTILS_H_
 
+/* maximum number of commands executed concurrently by execute_parallel_commands() */
+#define PARALLEL_COMMAND_MAX_WORKERS 16
+
+/* maximum number of concurrent multiplexed SSH sessions (see ssh_session_begin()) */
+#define MAX_SSH_SESSIONS 4
+
+/* maximum number of concurrently executing async notification commands */
+#define NOTIFICATION_QUEUE_MAX 8
+
+/*
+ * Describes one command in a batch executed by execute_parallel_commands().
+ * The caller initialises "id" (an arbitrary identifier, typically a node ID)
+ * and "command"; "output" and "success" are set by the executor.
+ */
+typedef struct
+{
+	int			id;
+	PQExpBufferData command;
+	PQExpBufferData output;
+	bool		success;
+} t_parallel_command;
+
 extern bool local_command(const char *command, PQExpBufferData *outputbuf);
 extern bool local_command_return_value(const char *command, PQExpBufferData *outputbuf, int *return_value);
 extern bool local_command_simple(const char *command, PQExpBufferData *outputbuf);
@@ -26,6 +48,15 @@ extern bool local_command_simple(const char *command, PQExpBufferData *outputbuf
 extern bool remote_command(const char *host, const char *user, const char *command, const char *ssh_options, PQExpBufferData *outputbuf);
 extern void make_remote_command(const char *host, const char *user, const char *command, const char *ssh_options, PQExpBufferData *ssh_command);
 
+extern bool ssh_session_begin(const char *host, const char *user, const char *ssh_options);
+extern void ssh_session_end_all(void);
+
+extern bool execute_parallel_commands(t_parallel_command *commands, int command_count, int max_workers);
+
+extern void enable_async_notifications(void);
+extern void reap_async_notifications(void);
+extern bool execute_notification_command(const char *command, const char *event);
+
 extern pid_t disable_wal_receiver(PGconn *conn);
 extern pid_t enable_wal_receiver(PGconn *conn, bool wait_startup);
 